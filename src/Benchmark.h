@@ -0,0 +1,94 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ * Minimal support for timing micro-benchmarks
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+class Benchmark {
+	// Results are accumulated here so that the timed code isn't elided
+	static inline volatile size_t sink;
+	static const int RUNS = 5;
+public:
+	/**
+	 * Time the passed function, which processes the specified number
+	 * of units (e.g. bytes or tokens) and returns a value depending on
+	 * them.
+	 * Report and return the best time per unit in ns.
+	 */
+	template <typename F>
+	static double run(const std::string &name, size_t units,
+			const char *unit_name, F f) {
+		double best = 0;
+
+		for (int i = 0; i < RUNS; i++) {
+			auto start = std::chrono::steady_clock::now();
+			sink = sink + f();
+			std::chrono::duration<double, std::nano> elapsed =
+				std::chrono::steady_clock::now() - start;
+			if (i == 0 || elapsed.count() < best)
+				best = elapsed.count();
+		}
+		double per_unit = best / units;
+		std::cout << std::left << std::setw(48) << name <<
+			std::right << std::setw(10) << std::fixed <<
+			std::setprecision(3) << per_unit << " ns/" <<
+			unit_name << std::endl;
+		return per_unit;
+	}
+
+	// Report the ratio between a baseline and an improved time
+	static void speedup(double before, double after) {
+		std::cout << std::left << std::setw(48) << "  speedup" <<
+			std::right << std::setw(10) << std::fixed <<
+			std::setprecision(2) << before / after << " x" <<
+			std::endl;
+	}
+
+	/**
+	 * Return synthetic C-like source code of (at least) the specified
+	 * size, containing identifiers, keywords, numbers, operators,
+	 * strings, and comments with some non-ASCII (UTF-8) text.
+	 */
+	static std::string source_code(size_t size) {
+		std::string s;
+
+		s.reserve(size + 256);
+		for (unsigned i = 0; s.size() < size; i++) {
+			std::string n(std::to_string(i));
+			s += "/*\n * Compute the value of item " + n +
+				" \xe2\x80\x94 caf\xc3\xa9 na\xc3\xafve\n */\n"
+				"static int\nfunction_" + n + "(int count, "
+				"const char *name)\n{\n"
+				"\tint total = " + n + ";\n\n"
+				"\tfor (int i = 0; i < count; i++) {\n"
+				"\t\tif (name[i] == '\\n' && total >= 0x1f)\n"
+				"\t\t\ttotal += i * 3.14e-2;\n"
+				"\t\telse\n"
+				"\t\t\ttotal -= i >> 2;\t// Adjust\n"
+				"\t}\n"
+				"\tprintf(\"%s: %d\\n\", name, total);\n"
+				"\treturn total;\n}\n\n";
+		}
+		return s;
+	}
+};
@@ -0,0 +1,175 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ * Write tokens in a compact binary format.
+ *
+ * The output starts with an eight-byte header:
+ * the magic characters "TOKB", the format version,
+ * the encoding (0: little-endian 32-bit values, 1: LEB128 varints),
+ * the processing type (0: file, 1: line, 2: method, 3: statement),
+ * and flags (1: compressed token values, 2: all contents, 4: positions,
+ * 8: n-gram counts, 16: MinHash signatures).
+ * The header is followed by the language name string.
+ *
+ * A series of records follows; each starts with its type.
+ * A file record (1) contains the file's name as a string.
+ * A unit record (2) contains the number of tokens in the unit
+ * (file, line, method, or statement) followed by the tokens.
+ * With positions, each unit record is followed by a positions record (3)
+ * containing the number of tokens followed by the line, column,
+ * and byte offset of each token.  The numbers of tokens and the
+ * positions are 64-bit quantities, written as two values (low and high)
+ * with 32-bit values, so units of any size can be represented.
+ * N-gram counts contain, instead of file and unit records,
+ * n-gram records (4) with the number of tokens in the n-gram,
+ * its tokens, and its count as a 64-bit quantity.
+ * MinHash signatures contain, instead of unit records,
+ * signature records (5) with the number of values in a unit's signature
+ * followed by the values, each a 32-bit quantity.
+ *
+ * All values are written in the specified encoding.
+ * Strings are written as their length followed by their characters;
+ * with 32-bit values the characters are padded with zeros to
+ * a multiple of four bytes, keeping all values aligned.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "OutputSink.h"
+#include "PositionTracker.h"
+#include "TokenId.h"
+
+class BinaryWriter {
+public:
+	static const unsigned char VERSION = 2;
+
+	enum Encoding : unsigned char {
+		UINT32,		// Little-endian 32-bit values
+		VARINT,		// LEB128 variable-length values
+	};
+
+	enum RecordType : uint32_t {
+		FILE_RECORD = 1,
+		UNIT_RECORD = 2,
+		POSITIONS_RECORD = 3,
+		NGRAM_RECORD = 4,
+		SIGNATURE_RECORD = 5,
+	};
+
+	enum Flags : unsigned char {
+		COMPRESSED = 1,		// Token values compressed (-c)
+		ALL_CONTENTS = 2,	// All contents tokenized (-a)
+		POSITIONS = 4,		// Token positions (-p)
+		NGRAMS = 8,		// N-gram counts (-n)
+		SIGNATURES = 16,	// MinHash signatures (-k)
+	};
+private:
+	OutputSink &out;
+	Encoding encoding;
+
+	// Write a single value in the specified encoding
+	void put(uint32_t v) {
+		char bytes[5];
+		int n = 0;
+
+		if (encoding == UINT32) {
+			for (; n < 4; n++, v >>= 8)
+				bytes[n] = (char)(v & 0xff);
+		} else {
+			for (; v >= 0x80; v >>= 7)
+				bytes[n++] = (char)((v & 0x7f) | 0x80);
+			bytes[n++] = (char)v;
+		}
+		out.write(bytes, n);
+	}
+
+	void put64(uint64_t v) {
+		if (encoding == UINT32) {
+			put(static_cast<uint32_t>(v));
+			put(static_cast<uint32_t>(v >> 32));
+		} else {
+			char bytes[10];
+			int n = 0;
+			for (; v >= 0x80; v >>= 7)
+				bytes[n++] = (char)((v & 0x7f) | 0x80);
+			bytes[n++] = (char)v;
+			out.write(bytes, n);
+		}
+	}
+
+	void put(const std::string &s) {
+		put(static_cast<uint32_t>(s.size()));
+		out << s;
+		if (encoding == UINT32)
+			for (size_t i = s.size(); i % 4; i++)
+				out << '\0';
+	}
+public:
+	BinaryWriter(OutputSink &o, Encoding e) : out(o), encoding(e) {}
+
+	/** Write the output's header */
+	void header(const std::string &language, unsigned char processing_type,
+			unsigned char flags) {
+		out << "TOKB" << (char)VERSION << (char)encoding <<
+			(char)processing_type << (char)flags;
+		put(language);
+	}
+
+	/** Write a record marking the start of the named file */
+	void file(const std::string &name) {
+		put(FILE_RECORD);
+		put(name);
+	}
+
+	/** Write a record containing the tokens of a unit */
+	void unit(const std::vector<token_type> &tokens) {
+		put(UNIT_RECORD);
+		put64(tokens.size());
+		for (auto t : tokens)
+			put(t);
+	}
+
+	/** Write a record containing the positions of a unit's tokens */
+	void positions(const std::vector<Position> &positions) {
+		put(POSITIONS_RECORD);
+		put64(positions.size());
+		for (auto &p : positions) {
+			put64(p.line);
+			put64(p.column);
+			put64(p.offset);
+		}
+	}
+
+	/** Write a record containing an n-gram's tokens and its count */
+	void ngram(const token_type *tokens, unsigned n, uint64_t count) {
+		put(NGRAM_RECORD);
+		put(n);
+		for (unsigned i = 0; i < n; i++)
+			put(tokens[i]);
+		put64(count);
+	}
+
+	/** Write a record containing a unit's MinHash signature */
+	void signature(const uint32_t *values, unsigned n) {
+		put(SIGNATURE_RECORD);
+		put(n);
+		for (unsigned i = 0; i < n; i++)
+			put(values[i]);
+	}
+};
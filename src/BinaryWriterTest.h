@@ -0,0 +1,173 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef BINARYWRITERTEST_H
+#define BINARYWRITERTEST_H
+
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "BinaryWriter.h"
+#include "CTokenizer.h"
+#include "Keyword.h"
+#include "OutputSink.h"
+
+class BinaryWriterTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(BinaryWriterTest);
+	CPPUNIT_TEST(testHeader);
+	CPPUNIT_TEST(testUint32);
+	CPPUNIT_TEST(testVarint);
+	CPPUNIT_TEST(testStatements);
+	CPPUNIT_TEST(testLines);
+	CPPUNIT_TEST(testPositionsRecord);
+	CPPUNIT_TEST(testPositions);
+	CPPUNIT_TEST(testNgram);
+	CPPUNIT_TEST_SUITE_END();
+
+	// Return a string with the specified bytes
+	static std::string bytes(std::initializer_list<unsigned char> l) {
+		return std::string(l.begin(), l.end());
+	}
+public:
+	void testHeader() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::VARINT);
+
+		w.header("C", 3, BinaryWriter::COMPRESSED);
+		CPPUNIT_ASSERT_EQUAL(std::string("TOKB") +
+			bytes({2, 1, 3, 1, 1, 'C'}), o.str());
+
+		OutputSink o2;
+		BinaryWriter w2(o2, BinaryWriter::UINT32);
+		w2.header("Go", 0, 0);
+		CPPUNIT_ASSERT_EQUAL(std::string("TOKB") +
+			bytes({2, 0, 0, 0, 2, 0, 0, 0, 'G', 'o', 0, 0}),
+			o2.str());
+	}
+
+	void testUint32() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::UINT32);
+
+		w.unit({1, 0x1234, 0x12345678});
+		CPPUNIT_ASSERT_EQUAL(bytes({2, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0,
+			1, 0, 0, 0, 0x34, 0x12, 0, 0, 0x78, 0x56, 0x34, 0x12}),
+			o.str());
+
+		o.clear();
+		w.file("a.c");
+		CPPUNIT_ASSERT_EQUAL(bytes({1, 0, 0, 0, 3, 0, 0, 0,
+			'a', '.', 'c', 0}), o.str());
+	}
+
+	void testVarint() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::VARINT);
+
+		w.unit({0x7f, 0x80, 300, 0xffffffff});
+		CPPUNIT_ASSERT_EQUAL(bytes({2, 4, 0x7f, 0x80, 0x01,
+			0xac, 0x02, 0xff, 0xff, 0xff, 0xff, 0x0f}), o.str());
+
+		o.clear();
+		w.unit({});
+		CPPUNIT_ASSERT_EQUAL(bytes({2, 0}), o.str());
+	}
+
+	// Units end where the text output ends its lines
+	void testStatements() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::UINT32);
+		CTokenizer t("int f() { return 0; }", {"statement"});
+
+		t.binary_tokenize(w, false);
+
+		OutputSink expect;
+		BinaryWriter we(expect, BinaryWriter::UINT32);
+		we.unit({'{', Keyword::K_return, TokenId::NUMBER_ZERO, ';'});
+		we.unit({'}'});
+		CPPUNIT_ASSERT_EQUAL(expect.str(), o.str());
+	}
+
+	// Output units are synchronized with the input lines
+	void testLines() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::VARINT);
+		CTokenizer t("a\n\nb c\n", {"line"});
+
+		t.binary_tokenize(w, true);
+
+		OutputSink expect;
+		BinaryWriter we(expect, BinaryWriter::VARINT);
+		we.unit({TokenId::ANY_IDENTIFIER});
+		we.unit({});
+		we.unit({TokenId::ANY_IDENTIFIER, TokenId::ANY_IDENTIFIER});
+		CPPUNIT_ASSERT_EQUAL(expect.str(), o.str());
+	}
+
+	void testPositionsRecord() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::UINT32);
+
+		w.positions({{2, 3, 0x100000004}});
+		CPPUNIT_ASSERT_EQUAL(bytes({3, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+			2, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0,
+			4, 0, 0, 0, 1, 0, 0, 0}), o.str());
+
+		OutputSink o2;
+		BinaryWriter w2(o2, BinaryWriter::VARINT);
+		w2.positions({{1, 1, 0}, {300, 2, 0x100000004}});
+		CPPUNIT_ASSERT_EQUAL(bytes({3, 2, 1, 1, 0, 0xac, 0x02, 2,
+			0x84, 0x80, 0x80, 0x80, 0x10}), o2.str());
+	}
+
+	// Each unit is followed by the positions of its tokens
+	void testPositions() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::VARINT);
+		CTokenizer t("if /* x\n */ else\n\t{;\n", {"line"});
+
+		t.set_positions(true);
+		t.binary_tokenize(w, false);
+
+		OutputSink expect;
+		BinaryWriter we(expect, BinaryWriter::VARINT);
+		we.unit({Keyword::K_if});
+		we.positions({{1, 1, 0}});
+		we.unit({Token::BLOCK_COMMENT, Keyword::K_else});
+		we.positions({{1, 4, 3}, {2, 5, 12}});
+		we.unit({'{', ';'});
+		we.positions({{3, 2, 18}, {3, 3, 19}});
+		CPPUNIT_ASSERT_EQUAL(expect.str(), o.str());
+	}
+
+	void testNgram() {
+		OutputSink o;
+		BinaryWriter w(o, BinaryWriter::UINT32);
+		token_type key[] = {1, 300};
+
+		w.ngram(key, 2, 0x100000002);
+		CPPUNIT_ASSERT_EQUAL(bytes({4, 0, 0, 0, 2, 0, 0, 0,
+			1, 0, 0, 0, 0x2c, 0x01, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0}),
+			o.str());
+
+		OutputSink o2;
+		BinaryWriter w2(o2, BinaryWriter::VARINT);
+		w2.ngram(key, 2, 3);
+		CPPUNIT_ASSERT_EQUAL(bytes({4, 2, 1, 0xac, 0x02, 3}), o2.str());
+	}
+};
+#endif /* BINARYWRITERTEST_H */
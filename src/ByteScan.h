@@ -0,0 +1,249 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ * Vectorized scanning of input buffers.
+ * SSE2 and AVX2 instructions are used when the compiler targets them;
+ * otherwise bytes are processed eight at a time as 64-bit words,
+ * or one at a time.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+class ByteScan {
+	static constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+	// Return the 64-bit word starting at p
+	static uint64_t word(const char *p) {
+		uint64_t w;
+		memcpy(&w, p, sizeof(w));
+		return w;
+	}
+public:
+	/**
+	 * Return a pointer to the first byte in [p, end) that is
+	 * not ASCII (has its high bit set), or end if there is none.
+	 */
+	static const char *find_non_ascii(const char *p, const char *end) {
+#if defined(__AVX2__)
+		for (; end - p >= 32; p += 32) {
+			__m256i v = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i *>(p));
+			unsigned mask = _mm256_movemask_epi8(v);
+			if (mask)
+				return p + __builtin_ctz(mask);
+		}
+#endif
+#if defined(__SSE2__)
+		for (; end - p >= 16; p += 16) {
+			__m128i v = _mm_loadu_si128(
+				reinterpret_cast<const __m128i *>(p));
+			unsigned mask = _mm_movemask_epi8(v);
+			if (mask)
+				return p + __builtin_ctz(mask);
+		}
+#endif
+		for (; end - p >= 8; p += 8)
+			if (word(p) & HIGH_BITS)
+				break;
+		for (; p < end; p++)
+			if (*p & 0x80)
+				return p;
+		return end;
+	}
+
+	/**
+	 * Return a pointer to the first ASCII byte in [p, end),
+	 * or end if there is none.
+	 */
+	static const char *skip_non_ascii(const char *p, const char *end) {
+#if defined(__AVX2__)
+		for (; end - p >= 32; p += 32) {
+			__m256i v = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i *>(p));
+			unsigned mask = ~_mm256_movemask_epi8(v);
+			if (mask)
+				return p + __builtin_ctz(mask);
+		}
+#endif
+#if defined(__SSE2__)
+		for (; end - p >= 16; p += 16) {
+			__m128i v = _mm_loadu_si128(
+				reinterpret_cast<const __m128i *>(p));
+			unsigned mask = ~_mm_movemask_epi8(v) & 0xffff;
+			if (mask)
+				return p + __builtin_ctz(mask);
+		}
+#endif
+		for (; end - p >= 8; p += 8)
+			if (~word(p) & HIGH_BITS)
+				break;
+		for (; p < end; p++)
+			if (!(*p & 0x80))
+				return p;
+		return end;
+	}
+
+	/**
+	 * Return a pointer to the first byte in [p, end) that is equal
+	 * to a or b, or end if there is none.
+	 * Add to newlines the number of newline characters before it.
+	 */
+	static const char *find_either(const char *p, const char *end,
+			char a, char b, uint64_t &newlines) {
+#if defined(__AVX2__)
+		const __m256i a32 = _mm256_set1_epi8(a);
+		const __m256i b32 = _mm256_set1_epi8(b);
+		const __m256i nl32 = _mm256_set1_epi8('\n');
+		for (; end - p >= 32; p += 32) {
+			__m256i v = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i *>(p));
+			unsigned found = _mm256_movemask_epi8(_mm256_or_si256(
+				_mm256_cmpeq_epi8(v, a32),
+				_mm256_cmpeq_epi8(v, b32)));
+			unsigned nl = _mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(v, nl32));
+			if (found) {
+				int pos = __builtin_ctz(found);
+				newlines += __builtin_popcount(nl &
+					((1u << pos) - 1));
+				return p + pos;
+			}
+			newlines += __builtin_popcount(nl);
+		}
+#endif
+#if defined(__SSE2__)
+		const __m128i a16 = _mm_set1_epi8(a);
+		const __m128i b16 = _mm_set1_epi8(b);
+		const __m128i nl16 = _mm_set1_epi8('\n');
+		for (; end - p >= 16; p += 16) {
+			__m128i v = _mm_loadu_si128(
+				reinterpret_cast<const __m128i *>(p));
+			unsigned found = _mm_movemask_epi8(_mm_or_si128(
+				_mm_cmpeq_epi8(v, a16),
+				_mm_cmpeq_epi8(v, b16)));
+			unsigned nl = _mm_movemask_epi8(
+				_mm_cmpeq_epi8(v, nl16));
+			if (found) {
+				int pos = __builtin_ctz(found);
+				newlines += __builtin_popcount(nl &
+					((1u << pos) - 1));
+				return p + pos;
+			}
+			newlines += __builtin_popcount(nl);
+		}
+#endif
+		for (; p < end; p++) {
+			if (*p == a || *p == b)
+				return p;
+			if (*p == '\n')
+				newlines++;
+		}
+		return end;
+	}
+
+	/**
+	 * The ASCII characters that form a word, such as an identifier
+	 * or a number: letters, digits, and up to three other characters.
+	 */
+	class WordChars {
+		char extra[3];
+	public:
+		constexpr WordChars(char a, char b = 0, char c = 0) :
+			extra{a, b ? b : a, c ? c : a} {}
+
+		bool contains(char c) const {
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+				(c >= '0' && c <= '9') || c == extra[0] ||
+				c == extra[1] || c == extra[2];
+		}
+
+		char get_extra(int i) const { return extra[i]; }
+	};
+
+	/**
+	 * Return a pointer to the first byte in [p, end) that is not
+	 * one of the specified word characters, or end if there is none.
+	 * Non-ASCII bytes are not word characters.
+	 */
+	static const char *skip_word(const char *p, const char *end,
+			const WordChars &w) {
+#if defined(__AVX2__)
+		const __m256i lower32 = _mm256_set1_epi8(0x20);
+		const __m256i a32 = _mm256_set1_epi8('a' - 1);
+		const __m256i z32 = _mm256_set1_epi8('z' + 1);
+		const __m256i d0_32 = _mm256_set1_epi8('0' - 1);
+		const __m256i d9_32 = _mm256_set1_epi8('9' + 1);
+		const __m256i e0_32 = _mm256_set1_epi8(w.get_extra(0));
+		const __m256i e1_32 = _mm256_set1_epi8(w.get_extra(1));
+		const __m256i e2_32 = _mm256_set1_epi8(w.get_extra(2));
+		for (; end - p >= 32; p += 32) {
+			__m256i v = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i *>(p));
+			// Setting bit 5 maps the upper case letters to lower
+			__m256i l = _mm256_or_si256(v, lower32);
+			__m256i in = _mm256_or_si256(
+				_mm256_and_si256(_mm256_cmpgt_epi8(l, a32),
+					_mm256_cmpgt_epi8(z32, l)),
+				_mm256_and_si256(_mm256_cmpgt_epi8(v, d0_32),
+					_mm256_cmpgt_epi8(d9_32, v)));
+			in = _mm256_or_si256(in, _mm256_or_si256(
+				_mm256_cmpeq_epi8(v, e0_32),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, e1_32),
+					_mm256_cmpeq_epi8(v, e2_32))));
+			unsigned mask = ~_mm256_movemask_epi8(in);
+			if (mask)
+				return p + __builtin_ctz(mask);
+		}
+#endif
+#if defined(__SSE2__)
+		const __m128i lower16 = _mm_set1_epi8(0x20);
+		const __m128i a16 = _mm_set1_epi8('a' - 1);
+		const __m128i z16 = _mm_set1_epi8('z' + 1);
+		const __m128i d0_16 = _mm_set1_epi8('0' - 1);
+		const __m128i d9_16 = _mm_set1_epi8('9' + 1);
+		const __m128i e0_16 = _mm_set1_epi8(w.get_extra(0));
+		const __m128i e1_16 = _mm_set1_epi8(w.get_extra(1));
+		const __m128i e2_16 = _mm_set1_epi8(w.get_extra(2));
+		for (; end - p >= 16; p += 16) {
+			__m128i v = _mm_loadu_si128(
+				reinterpret_cast<const __m128i *>(p));
+			__m128i l = _mm_or_si128(v, lower16);
+			__m128i in = _mm_or_si128(
+				_mm_and_si128(_mm_cmpgt_epi8(l, a16),
+					_mm_cmpgt_epi8(z16, l)),
+				_mm_and_si128(_mm_cmpgt_epi8(v, d0_16),
+					_mm_cmpgt_epi8(d9_16, v)));
+			in = _mm_or_si128(in, _mm_or_si128(
+				_mm_cmpeq_epi8(v, e0_16),
+				_mm_or_si128(_mm_cmpeq_epi8(v, e1_16),
+					_mm_cmpeq_epi8(v, e2_16))));
+			unsigned mask = ~_mm_movemask_epi8(in) & 0xffff;
+			if (mask)
+				return p + __builtin_ctz(mask);
+		}
+#endif
+		for (; p < end; p++)
+			if (!w.contains(*p))
+				return p;
+		return end;
+	}
+};
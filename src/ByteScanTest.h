@@ -0,0 +1,152 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef BYTESCANTEST_H
+#define BYTESCANTEST_H
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ByteScan.h"
+
+class ByteScanTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(ByteScanTest);
+	CPPUNIT_TEST(testFindNonAscii);
+	CPPUNIT_TEST(testFindNonAsciiNone);
+	CPPUNIT_TEST(testSkipNonAscii);
+	CPPUNIT_TEST(testSkipNonAsciiAll);
+	CPPUNIT_TEST(testFindEither);
+	CPPUNIT_TEST(testFindEitherNone);
+	CPPUNIT_TEST(testSkipWord);
+	CPPUNIT_TEST(testSkipWordAll);
+	CPPUNIT_TEST(testWordChars);
+	CPPUNIT_TEST_SUITE_END();
+
+	// Lengths covering the word, SSE2, and AVX2 paths and their tails
+	static const int MAX_LEN = 100;
+public:
+	void testFindNonAscii() {
+		for (int len = 1; len < MAX_LEN; len++)
+			for (int pos = 0; pos < len; pos++) {
+				std::string s(len, 'a');
+				s[pos] = '\xc3';
+				const char *b = s.data();
+				CPPUNIT_ASSERT_EQUAL(pos, static_cast<int>(
+					ByteScan::find_non_ascii(b, b + len) - b));
+			}
+	}
+
+	void testFindNonAsciiNone() {
+		for (int len = 0; len < MAX_LEN; len++) {
+			std::string s(len, '\x7f');
+			const char *b = s.data();
+			CPPUNIT_ASSERT(ByteScan::find_non_ascii(b, b + len) == b + len);
+		}
+	}
+
+	void testSkipNonAscii() {
+		for (int len = 1; len < MAX_LEN; len++)
+			for (int pos = 0; pos < len; pos++) {
+				std::string s(len, '\x80');
+				s[pos] = '\n';
+				const char *b = s.data();
+				CPPUNIT_ASSERT_EQUAL(pos, static_cast<int>(
+					ByteScan::skip_non_ascii(b, b + len) - b));
+			}
+	}
+
+	void testSkipNonAsciiAll() {
+		for (int len = 0; len < MAX_LEN; len++) {
+			std::string s(len, '\xff');
+			const char *b = s.data();
+			CPPUNIT_ASSERT(ByteScan::skip_non_ascii(b, b + len) == b + len);
+		}
+	}
+
+	void testFindEither() {
+		for (int len = 1; len < MAX_LEN; len++)
+			for (int pos = 0; pos < len; pos++) {
+				std::string s(len, 'a');
+				uint64_t expect_newlines = 0;
+				for (int i = 0; i < len; i += 3) {
+					s[i] = '\n';
+					if (i < pos)
+						expect_newlines++;
+				}
+				s[pos] = (pos & 1) ? '"' : '\\';
+				const char *b = s.data();
+				uint64_t newlines = 0;
+				CPPUNIT_ASSERT_EQUAL(pos, static_cast<int>(
+					ByteScan::find_either(b, b + len, '"', '\\',
+					newlines) - b));
+				CPPUNIT_ASSERT_EQUAL(expect_newlines, newlines);
+			}
+	}
+
+	void testFindEitherNone() {
+		for (int len = 0; len < MAX_LEN; len++) {
+			std::string s(len, '\n');
+			const char *b = s.data();
+			uint64_t newlines = 0;
+			CPPUNIT_ASSERT(ByteScan::find_either(b, b + len, '*', '*',
+				newlines) == b + len);
+			CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(len), newlines);
+		}
+	}
+
+	void testSkipWord() {
+		const ByteScan::WordChars w('_', '$');
+		const char stops[] = { ' ', '@', '[', '`', '{', '/', ':', '\x80' };
+		for (int len = 1; len < MAX_LEN; len++)
+			for (int pos = 0; pos < len; pos++) {
+				std::string s;
+				for (int i = 0; i < len; i++)
+					s += "aZ09_$"[i % 6];
+				s[pos] = stops[pos % sizeof(stops)];
+				const char *b = s.data();
+				CPPUNIT_ASSERT_EQUAL(pos, static_cast<int>(
+					ByteScan::skip_word(b, b + len, w) - b));
+			}
+	}
+
+	void testSkipWordAll() {
+		const ByteScan::WordChars w('.', '_', '\'');
+		for (int len = 0; len < MAX_LEN; len++) {
+			std::string s;
+			for (int i = 0; i < len; i++)
+				s += "1.e_'Fx"[i % 7];
+			const char *b = s.data();
+			CPPUNIT_ASSERT(ByteScan::skip_word(b, b + len, w) == b + len);
+		}
+	}
+
+	// The vectorized classification agrees with the scalar one
+	void testWordChars() {
+		const ByteScan::WordChars w('_', '\\');
+		for (int c = 0; c < 256; c++) {
+			std::string s(40, static_cast<char>(c));
+			const char *b = s.data();
+			bool in = ByteScan::skip_word(b, b + s.size(), w) != b;
+			CPPUNIT_ASSERT_EQUAL(w.contains(static_cast<char>(c)), in);
+			CPPUNIT_ASSERT_EQUAL(in, c < 128 &&
+				(isalnum(c) || c == '_' || c == '\\'));
+		}
+	}
+};
+#endif /* BYTESCANTEST_H */
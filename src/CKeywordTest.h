@@ -29,6 +29,7 @@ class CKeywordTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testTypedef);
 	CPPUNIT_TEST(testId);
 	CPPUNIT_TEST(testInclude);
+	CPPUNIT_TEST(testAllLanguages);
 	CPPUNIT_TEST_SUITE_END();
 	Keyword ck;
 public:
@@ -63,6 +64,35 @@ public:
 		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("returning"), Keyword::FIRST_IDENTIFIER);
 		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("id"), Keyword::FIRST_IDENTIFIER);
 		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("xyzzy"), Keyword::FIRST_IDENTIFIER);
+		CPPUNIT_ASSERT_EQUAL(ck.identifier_type(""), Keyword::FIRST_IDENTIFIER);
+		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("i"), Keyword::FIRST_IDENTIFIER);
+		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("iff"), Keyword::FIRST_IDENTIFIER);
+		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("IF"), Keyword::FIRST_IDENTIFIER);
+		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("class"), Keyword::FIRST_IDENTIFIER);
+		CPPUNIT_ASSERT_EQUAL(ck.identifier_type("a_very_long_identifier"), Keyword::FIRST_IDENTIFIER);
+	}
+
+	// Each language's hash table recognizes exactly its keywords
+	void testAllLanguages() {
+		int n = 0;
+
+		for (int l = Keyword::L_C; l <= Keyword::L_TypeScript; l++) {
+			Keyword k(static_cast<Keyword::LanguageId>(l));
+
+			for (auto t : k.token_keyword_view()) {
+				auto id = k.identifier_type(t.second);
+				CPPUNIT_ASSERT(id == Keyword::FIRST_IDENTIFIER ||
+					id == t.first);
+				if (id != Keyword::FIRST_IDENTIFIER)
+					n++;
+				// Prefixes aren't confused with keywords
+				std::string prefix(t.second, 0, t.second.size() - 1);
+				CPPUNIT_ASSERT(k.identifier_type(prefix) !=
+					t.first);
+			}
+		}
+		// Lines of the *-keyword.txt files, less a duplicate
+		CPPUNIT_ASSERT_EQUAL(875, n);
 	}
 };
 #endif /*  CKEYWORDTEST_H */
@@ -24,6 +24,7 @@
 #include "CSharpTokenizer.h"
 #include "Token.h"
 
+template <bool AllContents>
 inline token_type
 CSharpTokenizer::get_token_real()
 {
@@ -34,7 +35,7 @@ CSharpTokenizer::get_token_real()
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -62,188 +63,24 @@ CSharpTokenizer::get_token_real()
 		case ';':
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
-		/*
-		 * Double character C tokens with more than 2 different outcomes
-		 * (e.g. +, +=, ++)
-		 */
-		case '+':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '+':
-				return Token::PLUS_PLUS; // ++
-			case '=':
-				return Token::PLUS_EQUAL; // +=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '-':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '-':
-				return Token::MINUS_MINUS; // --
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			case '>':
-				return Token::MEMBER_PTR; // ->
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '&':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '&':
-				return Token::BOOLEAN_AND; // &&
-			case '=':
-				return Token::AND_EQUAL; // &=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '|':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '|':
-				return Token::BOOLEAN_OR; // ||
-			case '=':
-				return Token::OR_EQUAL; // |=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '=':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::EQUAL; // ==
-			case '>':
-				return Token::LAMBDA; // =>
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '?':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '.':
-				return Token::NULL_CONDITIONAL; // ?.
-			case '?':
-				return Token::NULL_COALESCE; // ??
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Simple single/double character tokens (e.g. !, !=) */
-		case '!':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::NOT_EQUAL; // !=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '%':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '*':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::TIMES_EQUAL; // *=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '^':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Operators starting with < or > */
-		case '>':
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case '<': case '=': case '>': case '?': case '^': case '|':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* >= */
-				return Token::GREATER_EQUAL; // >=
-			case '>':
-				src.get(c1);
-				if (c1 == '=')			/* >>= */
-					return Token::RSHIFT_EQUAL; // >>=
-				else {			/* << */
-					src.push(c1);
-					return Token::RSHIFT; // >>
-				}
-				break;
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '<':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* <= */
-				return Token::LESS_EQUAL; // <=
-			case '<':
-				src.get(c1);
-				if (c1 == '=')			/* <<= */
-					return Token::LSHIFT_EQUAL; // <<=
-				else {			/* << */
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-				break;
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_operator_token(c0, Operator::CSharp);
 		/* Comments and / operators */
 		case '/':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* /= */
-				return Token::DIV_EQUAL; // /=
+			switch (src.peek()) {
 			case '*':				/* Block comment */
-				return get_block_comment_token();
+				src.get(c1);
+				return get_block_comment_token<AllContents>();
 			case '/':				/* Line comment */
-				return get_line_comment_token();
-			default:				/* / */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+				src.get(c1);
+				return get_line_comment_token<AllContents>();
+			default:				/* / /= */
+				return get_operator_token(c0, Operator::CSharp);
 			}
-			break;
 		case '#':
 			if (bol.at_bol_space())
 				scan_cpp_directive = true;
@@ -260,25 +97,18 @@ CSharpTokenizer::get_token_real()
 		case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
 		case 'V': case 'W': case 'X': case 'Y': case 'Z':
 			bol.saw_non_space();
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				if (!isalnum(c0) && c0 != '_')
-					break;
-				val += c0;
-			}
-			src.push(c0);
-			key = keyword.identifier_type(val);
+			get_word_value(c0, identifier_chars);
+			key = keyword.identifier_type(value);
 			switch (key) {
 			case Keyword::K_region:
 			case Keyword::K_warning:
 			case Keyword::K_error:
 				if (scan_cpp_directive) {
 					scan_cpp_directive = false;
-					(void)get_line_comment_token();
+					(void)get_line_comment_token<AllContents>();
 					return key;
 				} else
-					return symbols.value(val);
+					return symbols.value(value);
 			case Keyword::K_define:
 			case Keyword::K_elif:
 			case Keyword::K_endif:
@@ -293,9 +123,9 @@ CSharpTokenizer::get_token_real()
 					scan_cpp_directive = false;
 					return key;
 				} else
-					return symbols.value(val);
+					return symbols.value(value);
 			case Keyword::FIRST_IDENTIFIER:
-				return symbols.value(val);
+				return symbols.value(value);
 			case Keyword::K_class:
 			case Keyword::K_interface:
 			case Keyword::K_enum:
@@ -308,13 +138,13 @@ CSharpTokenizer::get_token_real()
 			break;
 		case '\'':
 			bol.saw_non_space();
-			if (process_char_literal())
+			if (process_char_literal<AllContents>())
 				return Token::CHAR_LITERAL; // '.'
 			else
 				return 0;
 		case '"':
 			bol.saw_non_space();
-			if (process_string_literal())
+			if (process_string_literal<AllContents>())
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
@@ -322,8 +152,7 @@ CSharpTokenizer::get_token_real()
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
 			bol.saw_non_space();
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
@@ -331,14 +160,15 @@ CSharpTokenizer::get_token_real()
 	}
 }
 
+template <bool AllContents>
 inline token_type
-CSharpTokenizer::get_immediate_token()
+CSharpTokenizer::lex_token()
 {
 	token_type token;
 
 	// Merge consecutive doc comments
 	do {
-		token = get_token_real();
+		token = get_token_real<AllContents>();
 	} while (previous_token == Token::LINE_DOC_COMMENT && token == Token::LINE_DOC_COMMENT);
 	previous_token = token;
 	return token;
@@ -347,3 +177,7 @@ CSharpTokenizer::get_immediate_token()
 CSharpTokenizer::~CSharpTokenizer()
 {
 }
+
+template token_type CSharpTokenizer::lex_token<false>();
+template token_type CSharpTokenizer::lex_token<true>();
+template class TokenizerImpl<CSharpTokenizer>;
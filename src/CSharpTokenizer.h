@@ -24,18 +24,19 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class CSharpTokenizer : public TokenizerBase {
+class CSharpTokenizer : public TokenizerImpl<CSharpTokenizer> {
 private:
 	Token csharp_token;
-	token_type get_token_real();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type get_token_real();
 	token_type previous_token;		// Previously returned token
 	bool scan_cpp_directive;	// Keyword after a preprocessor #
 public:
 	// Return a single token coalescing together multiple line doc comments
-	token_type get_immediate_token();
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -53,16 +54,17 @@ public:
 	// Construct from a character source
 	CSharpTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_CSharp, s, file_name, opt),
+		TokenizerImpl(Keyword::L_CSharp, s, file_name, opt),
 		scan_cpp_directive(false) {}
 
 	// Construct for a string source
 	CSharpTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_CSharp, s, opt),
+		TokenizerImpl(Keyword::L_CSharp, s, opt),
 		scan_cpp_directive(false) {}
 
 	~CSharpTokenizer();
 
 	friend class CSharpTokenizerTest;
 };
+extern template class TokenizerImpl<CSharpTokenizer>;
 #endif /* CSHARPTOKENIZER_H */
@@ -25,17 +25,18 @@
 #include "CTokenizer.h"
 #include "Token.h"
 
+template <bool AllContents>
 inline token_type
-CTokenizer::get_immediate_token()
+CTokenizer::lex_token()
 {
-	char c0, c1, c2;
+	char c0, c1;
 	Keyword::IdentifierType key;
 
 	for (;;) {
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -65,213 +66,48 @@ CTokenizer::get_immediate_token()
 			bol.saw_non_space();
 			nesting.unsaw_class();
 			return static_cast<token_type>(c0);
-		/*
-		 * Double character C tokens with more than 2 different outcomes
-		 * (e.g. +, +=, ++)
-		 */
-		case '+':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '+':
-				return Token::PLUS_PLUS; // ++
-			case '=':
-				return Token::PLUS_EQUAL; // +=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '-':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '-':
-				return Token::MINUS_MINUS; // --
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			case '>':
-				return Token::RIGHT_SLIM_ARROW; // ->
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '&':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '&':
-				return Token::BOOLEAN_AND; // &&
-			case '=':
-				return Token::AND_EQUAL; // &=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '|':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '|':
-				return Token::BOOLEAN_OR; // ||
-			case '=':
-				return Token::OR_EQUAL; // |=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Simple single/double character tokens (e.g. !, !=) */
-		case '!':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::NOT_EQUAL; // !=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '%':
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case '<': case '=': case '>': case '^': case '|':
 			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '*':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::TIMES_EQUAL; // *=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '=':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::EQUAL; // ==
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '^':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_operator_token(c0, Operator::C);
 		case '#':
-			src.get(c1);
-			if (c1 == '#')
-				return Token::TOKEN_PASTE; // ##
-			else
-				src.push(c1);
+			if (get_operator_token(c0, Operator::C) == Token::TOKEN_PASTE)
+				return Token::TOKEN_PASTE;
 			if (bol.at_bol_space())
 				scan_cpp_directive = true;
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
-		/* Operators starting with < or > */
-		case '>':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* >= */
-				return Token::GREATER_EQUAL; // >=
-			case '>':
-				src.get(c1);
-				if (c1 == '=')			/* >>= */
-					return Token::RSHIFT_EQUAL; // >>=
-				else {				/* >> */
-					src.push(c1);
-					return Token::RSHIFT; // >>
-				}
-				break;
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '<':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* <= */
-				return Token::LESS_EQUAL; // <=
-			case '<':
-				src.get(c1);
-				if (c1 == '=')			/* <<= */
-					return Token::LSHIFT_EQUAL; // <<=
-				else {			/* << */
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-				break;
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
 		/* Comments and / operators */
 		case '/':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* /= */
-				return Token::DIV_EQUAL; // /=
+			switch (src.peek()) {
 			case '*':				/* Block comment */
-				return get_block_comment_token();
+				src.get(c1);
+				return get_block_comment_token<AllContents>();
 			case '/':				/* Line comment */
-				return get_line_comment_token();
-			default:				/* / */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+				src.get(c1);
+				return get_line_comment_token<AllContents>();
+			default:				/* / /= */
+				return get_operator_token(c0, Operator::C);
 			}
-			break;
 		case '.':	/* . and ... */
 			bol.saw_non_space();
-			src.get(c1);
-			if (isdigit(c1)) {
-				val = std::string(".") + (char)(c1);
-				return get_number_token(val);
-			}
-			if (c1 != '.') {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			src.get(c2);
-			if (c2 != '.') {
-				src.push(c2);
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			return Token::ELIPSIS; // ...
-			// Elipsis
+			if (isdigit(src.peek()))
+				return get_number_token(c0);
+			return get_operator_token(c0, Operator::C);
 		/* Could be a long character or string */
 		case 'L':
 			bol.saw_non_space();
 			src.get(c1);
 			switch (c1) {
 			case '\'':
-				if (process_char_literal())
+				if (process_char_literal<AllContents>())
 					return Token::CHAR_LITERAL; // '.'
 				else
 					return 0;
 			case '"':
-				if (process_string_literal())
+				if (process_string_literal<AllContents>())
 					return Token::STRING_LITERAL; // \"...\"
 				else
 					return 0;
@@ -290,15 +126,8 @@ CTokenizer::get_immediate_token()
 		case 'W': case 'X': case 'Y': case 'Z':
 		identifier:
 			bol.saw_non_space();
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				if (!isalnum(c0) && c0 != '_')
-					break;
-				val += c0;
-			}
-			src.push(c0);
-			key = keyword.identifier_type(val);
+			get_word_value(c0, identifier_chars);
+			key = keyword.identifier_type(value);
 			switch (key) {
 			case Keyword::K_define:
 			case Keyword::K_elif:
@@ -314,10 +143,10 @@ CTokenizer::get_immediate_token()
 					scan_cpp_directive = false;
 					return key;
 				} else
-					return symbols.value(val);
+					return symbols.value(value);
 				break;
 			case Keyword::FIRST_IDENTIFIER:
-				return symbols.value(val);
+				return symbols.value(value);
 			case Keyword::FIRST:
 			case Keyword::LAST:
 				assert(false);
@@ -329,13 +158,13 @@ CTokenizer::get_immediate_token()
 			break;
 		case '\'':
 			bol.saw_non_space();
-			if (process_char_literal())
+			if (process_char_literal<AllContents>())
 				return Token::CHAR_LITERAL; // '.'
 			else
 				return 0;
 		case '"':
 			bol.saw_non_space();
-			if (process_string_literal())
+			if (process_string_literal<AllContents>())
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
@@ -343,8 +172,7 @@ CTokenizer::get_immediate_token()
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
 			bol.saw_non_space();
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
@@ -355,3 +183,7 @@ CTokenizer::get_immediate_token()
 CTokenizer::~CTokenizer()
 {
 }
+
+template token_type CTokenizer::lex_token<false>();
+template token_type CTokenizer::lex_token<true>();
+template class TokenizerImpl<CTokenizer>;
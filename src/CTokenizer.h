@@ -24,16 +24,17 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class CTokenizer : public TokenizerBase {
+class CTokenizer : public TokenizerImpl<CTokenizer> {
 private:
 	bool scan_cpp_directive;	// Keyword after a C preprocessor #
 	/** True for keywords that don't end with semicolon */
 	Token ctoken;
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -50,14 +51,15 @@ public:
 	// Construct from a character source
 	CTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_C, s, file_name, opt),
+		TokenizerImpl(Keyword::L_C, s, file_name, opt),
 		scan_cpp_directive(false) {}
 
 	// Construct for a string source
 	CTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_C, s, opt),
+		TokenizerImpl(Keyword::L_C, s, opt),
 		scan_cpp_directive(false) {}
 
 	~CTokenizer();
 };
+extern template class TokenizerImpl<CTokenizer>;
 #endif /* CTOKENIZER_H */
@@ -0,0 +1,96 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CharSource.h"
+
+// Map regular files into memory; read all others in blocks
+CharSource::CharSource(int f) : in(nullptr), fd(f), map(nullptr),
+	map_size(0), at_eof(false), begin(nullptr), cur(nullptr),
+	end(nullptr), ascii_end(nullptr), base(nullptr), base_offset(0),
+	head(0), nreturned(0), npending(0), npushed(0), nchar(0), newlines(0)
+{
+	struct stat sb;
+
+	if (fstat(fd, &sb) == -1 || !S_ISREG(sb.st_mode) || sb.st_size == 0)
+		return;
+
+	void *p = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+		return;		// Fall back to reading blocks
+
+	(void)madvise(p, sb.st_size, MADV_SEQUENTIAL);
+	map = static_cast<char *>(p);
+	map_size = sb.st_size;
+	begin = cur = ascii_end = base = map;
+	end = map + map_size;
+	// A mapped file is available in its entirety
+	at_eof = true;
+}
+
+CharSource::~CharSource()
+{
+	if (map)
+		munmap(map, map_size);
+}
+
+/*
+ * Read the next block of input after keeping the last few characters
+ * of the previous one, so that the cursor can move back over them.
+ * Return false on EOF.
+ */
+bool
+CharSource::fill()
+{
+	if (at_eof)
+		return false;
+
+	if (block.empty())
+		block.resize(BLOCK_KEEP + BLOCK_SIZE);
+
+	size_t keep = std::min<size_t>(end - begin, BLOCK_KEEP);
+	if (keep)
+		memmove(block.data(), end - keep, keep);
+	char *data = block.data() + keep;
+
+	ssize_t n;
+	if (in) {
+		in->read(data, BLOCK_SIZE);
+		n = in->gcount();
+	} else {
+		do {
+			n = read(fd, data, BLOCK_SIZE);
+		} while (n == -1 && errno == EINTR);
+	}
+
+	if (n <= 0) {
+		at_eof = true;
+		return false;
+	}
+
+	base_offset += end - base;
+	begin = block.data();
+	cur = ascii_end = base = data;
+	end = data + n;
+	return true;
+}
@@ -1,31 +1,135 @@
 #ifndef CHARSOURCE_H
 #define CHARSOURCE_H
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
-#include <deque>
 #include <iostream>
-#include <stack>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ByteScan.h"
 
 /**
- * A source of characters coming from standard input with
+ * A source of characters coming from a contiguous input buffer with
  * infinite push back capability.
+ * The buffer is either a memory-mapped file, or a block read from
+ * a (non-mappable) file descriptor or from an input stream.
+ * Characters pushed back are normally undone by moving the read cursor
+ * backward; those that differ from the input are kept in a fixed-size
+ * circular window, which also holds the recently returned characters.
  */
 class CharSource {
 private:
-	std::stack<char> pushed_char;
-	std::deque<char> returned_char;
-	std::istream &in;
-	int nchar;		// Number of characters read
-	int newlines;		// Count encountered newlines
+	std::istream *in;	// Stream to read blocks from, or nullptr
+	int fd;			// File descriptor to read blocks from, or -1
+	char *map;		// Memory-mapped file contents, or nullptr
+	size_t map_size;	// Size of the memory-mapped area
+	std::vector<char> block;	// Storage for the data read in blocks
+	bool at_eof;		// True after the input has been exhausted
+	const char *begin;	// Earliest position the cursor can move back to
+	const char *cur;	// Next character to read
+	const char *end;	// End of the available data
+	const char *ascii_end;	// End of ASCII characters starting at cur
+	const char *base;	// Address of the input byte at base_offset
+	uint64_t base_offset;	// Offset of base from the input's start
 	/**
 	 * Maximum number of characters that can be pushed back, with
 	 * get_before() still returning a valid value (not 0).
-	 * Without this we must maintain a returned_char queue with
+	 * Without this we must maintain a returned character window with
 	 * a size equal to the file read.
 	 */
-	static const size_t MAX_REWIND = 10;
+	static const int MAX_REWIND = 10;
+	/**
+	 * Size of the circular window of returned and pushed characters.
+	 * The window also limits how many characters that differ from
+	 * the input can be pushed back in a row.
+	 */
+	static const unsigned WINDOW_SIZE = 64;
+	static_assert((WINDOW_SIZE & (WINDOW_SIZE - 1)) == 0,
+		"Window size must be a power of two");
+	char window[WINDOW_SIZE];
+	unsigned head;		// Window position of the next character
+	int nreturned;		// Returned characters available before head
+	int npending;		// Pushed characters stored in the window
+	int npushed;		// All characters currently pushed back
+	uint64_t nchar;		// Number of characters read
+	uint64_t newlines;	// Count encountered newlines
+	/** Size of each block read from a stream or a file descriptor */
+	static const size_t BLOCK_SIZE = 256 * 1024;
+	/**
+	 * Number of characters kept from the previous block when reading
+	 * a new one, so that the cursor can still be moved back over them.
+	 */
+	static const size_t BLOCK_KEEP = 64;
+
+	// Make more input available; return false on EOF
+	bool fill();
+
+	/*
+	 * Skip a run of non-ASCII characters, and find the end of the
+	 * ASCII run that follows it. Return false on EOF.
+	 */
+	bool scan_ascii() {
+		for (;;) {
+			if (cur == end && !fill())
+				return false;
+			const char *p = ByteScan::skip_non_ascii(cur, end);
+			nchar += p - cur;
+			cur = p;
+			if (cur != end) {
+				ascii_end = ByteScan::find_non_ascii(cur, end);
+				return true;
+			}
+		}
+	}
+
+	// Move the cursor back over the previously read c; false if not possible
+	bool unread(char c) {
+		const char *p = cur;
+
+		// Non-ASCII characters were skipped when reading
+		do {
+			if (p == begin)
+				return false;
+			p--;
+		} while (*p & 0x80);
+		if (*p != c)
+			return false;
+		cur = p;
+		return true;
+	}
 public:
-	CharSource(std::istream &s = std::cin) : in(s), nchar(0), newlines(0) {}
+	/** Read characters in blocks from the specified stream */
+	CharSource(std::istream &s = std::cin) : in(&s), fd(-1), map(nullptr),
+		map_size(0), at_eof(false), begin(nullptr), cur(nullptr),
+		end(nullptr), ascii_end(nullptr), base(nullptr), base_offset(0),
+		head(0), nreturned(0),
+		npending(0), npushed(0), nchar(0), newlines(0) {}
+
+	/**
+	 * Read characters from the specified memory buffer,
+	 * which must remain valid while the source is used.
+	 */
+	CharSource(const char *data, size_t size) : in(nullptr), fd(-1),
+		map(nullptr), map_size(0), at_eof(true), begin(data),
+		cur(data), end(data + size), ascii_end(data), base(data),
+		base_offset(0), head(0), nreturned(0),
+		npending(0), npushed(0), nchar(0), newlines(0) {}
+
+	/**
+	 * Read characters from the specified open file descriptor.
+	 * Regular files are memory-mapped; other files are read in blocks.
+	 * The descriptor is not closed by the character source.
+	 */
+	CharSource(int fd);
+
+	CharSource(const CharSource &) = delete;
+	CharSource &operator=(const CharSource &) = delete;
+
+	~CharSource();
 
 	/*
 	 * Obtain the next valid character from the source.
@@ -36,31 +140,163 @@ public:
 	 * On EOF return false and set c to 0.
 	 */
 	bool get(char &c) {
-		if (pushed_char.empty()) {
+		if (npushed == 0) {
 			// Read, ignoring non ASCII-characters
-			do {
-				if (!in.get(c)) {
-					c = 0;
-					return false;
-				}
-				nchar++;
-			} while (c < 0 || c > 127);
+			if (cur == ascii_end && !scan_ascii()) {
+				c = 0;
+				return false;
+			}
+			c = *cur++;
+			nchar++;
 		} else {
-			c = pushed_char.top();
-			pushed_char.pop();
+			npushed--;
+			if (npending) {
+				npending--;
+				c = window[head % WINDOW_SIZE];
+			} else {
+				// Reread input skipping the non-ASCII characters
+				while (*cur & 0x80)
+					cur++;
+				c = *cur++;
+			}
 		}
 		if (c == '\n')
 			newlines++;
-		returned_char.push_back(c);
-		while (returned_char.size() > MAX_REWIND)
-			returned_char.pop_front();
+		window[head++ % WINDOW_SIZE] = c;
+		if (nreturned < MAX_REWIND)
+			nreturned++;
 		return true;
 	}
 
+	/**
+	 * Skip the characters before the next one equal to a or b,
+	 * so that it is the next one get() returns, or to EOF.
+	 * The line number and the number of characters read are
+	 * maintained, but the skipped characters are not available
+	 * through char_before().
+	 * Nothing is skipped while pushed back characters are pending.
+	 */
+	void skip_to(char a, char b) {
+		if (npushed)
+			return;
+		for (;;) {
+			const char *p = ByteScan::find_either(cur, end, a, b,
+				newlines);
+			if (p != cur) {
+				nchar += p - cur;
+				nreturned = 0;
+				cur = p;
+				// Keep the ASCII run, if the skip ended within it
+				if (ascii_end < cur)
+					ascii_end = cur;
+			}
+			if (cur != end || !fill())
+				return;
+		}
+	}
+
+	/**
+	 * Append to val the run of word characters w that follow,
+	 * leaving the character after them as the next one to get.
+	 * Non-ASCII characters are ignored, as with get().
+	 * The appended characters are not available through char_before().
+	 */
+	void get_word(std::string &val, const ByteScan::WordChars &w) {
+		char c;
+
+		while (npushed) {
+			if (!get(c))
+				return;
+			if (!w.contains(c)) {
+				push(c);
+				return;
+			}
+			val += c;
+		}
+		for (;;) {
+			const char *p = ByteScan::skip_word(cur, end, w);
+			if (p != cur) {
+				val.append(cur, p - cur);
+				nchar += p - cur;
+				nreturned = 0;
+				cur = p;
+				if (ascii_end < cur)
+					ascii_end = cur;
+			}
+			if (cur == end) {
+				if (!fill())
+					return;
+			} else if (*cur & 0x80) {
+				p = ByteScan::skip_non_ascii(cur, end);
+				nchar += p - cur;
+				cur = ascii_end = p;
+			} else
+				return;
+		}
+	}
+
+	/**
+	 * Return a view of c, the character get() just returned, followed
+	 * by the run of word characters w after it, leaving the character
+	 * after them as the next one to get.
+	 * The view remains valid for the lifetime of the source.
+	 * Return an empty view, without reading anything, if the characters
+	 * are not contiguous in a stable input buffer: when characters are
+	 * pushed back, when the run contains non-ASCII characters, or when
+	 * the input is read in blocks.
+	 */
+	std::string_view view_word(char c, const ByteScan::WordChars &w) {
+		if (npushed || (!map && (in || fd != -1)) || cur == begin ||
+		    cur[-1] != c)
+			return std::string_view();
+		const char *p = ByteScan::skip_word(cur, end, w);
+		if (p != end && (*p & 0x80))
+			return std::string_view();
+		std::string_view word(cur - 1, p - cur + 1);
+		if (p != cur) {
+			nchar += p - cur;
+			nreturned = 0;
+			cur = p;
+			if (ascii_end < cur)
+				ascii_end = cur;
+		}
+		return word;
+	}
+
+	/**
+	 * Return the address of the input byte at the specified offset
+	 * from the input's start, or nullptr if it isn't in the buffer.
+	 * The end of the available data is also a valid address.
+	 */
+	const char *address(uint64_t offset) const {
+		ptrdiff_t d = static_cast<ptrdiff_t>(offset - base_offset);
+		if (d < begin - base || d > end - base)
+			return nullptr;
+		return base + d;
+	}
+
+	// Return the offset from the input's start of a buffer address
+	uint64_t offset(const char *p) const { return base_offset + (p - base); }
+
+	// Return the start and the end of the data in the buffer
+	const char *data_begin() const { return begin; }
+	const char *data_end() const { return end; }
+
+	/**
+	 * Return the entire input, if it is available in memory before
+	 * being read, as is the case for mapped files and memory buffers.
+	 * Otherwise, return an empty view.
+	 */
+	std::string_view contents() const {
+		if (!at_eof || nchar || npushed)
+			return std::string_view();
+		return std::string_view(begin, end - begin);
+	}
+
 	/**
 	 * Return current line number
 	 */
-	int line_number() { return newlines + 1; }
+	uint64_t line_number() { return newlines + 1; }
 
 	/**
 	 * Return (peek) the next character from source without removing it
@@ -75,33 +311,48 @@ public:
 			return 0;
 	}
 
+	/**
+	 * Return the next character without removing it from the source,
+	 * like char_after(), but without pushing it back when it is
+	 * available in the input.
+	 */
+	char peek() {
+		if (npushed == 0 && cur != ascii_end)
+			return *cur;
+		return char_after();
+	}
+
 	/**
 	 * Return the nth character before the one returned
 	 * Return 0 if no such character is available.
 	 */
 	char char_before(int n = 1) {
-		int index = returned_char.size() - n - 1;
-
-		if (index >= 0)
-			return returned_char[index];
+		if (n < nreturned)
+			return window[(head - 1 - n) % WINDOW_SIZE];
 		else
 			return 0;
 	}
 
 	/** Return number of characters read */
-	int get_nchar() const { return nchar - pushed_char.size(); }
+	uint64_t get_nchar() const { return nchar - npushed; }
 
 	/**
 	 * Push the specified character back into the source
 	 * In effect, this is an undo of the last get, and therefore
-	 * also moves back one character in the returned character queue.
+	 * also moves back one character in the returned character window.
 	 * */
 	void push(char c) {
 		if (c == '\n')
 			newlines--;
-		pushed_char.push(c);
-		if (returned_char.size() > 0)
-			returned_char.pop_back();
+		npushed++;
+		head--;
+		if (nreturned > 0)
+			nreturned--;
+		if (npending || !unread(c)) {
+			assert(npending < static_cast<int>(WINDOW_SIZE) - MAX_REWIND);
+			window[head % WINDOW_SIZE] = c;
+			npending++;
+		}
 	}
 };
 #endif /* CHARSOURCE_H */
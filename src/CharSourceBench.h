@@ -0,0 +1,125 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef CHARSOURCEBENCH_H
+#define CHARSOURCEBENCH_H
+
+#include <cctype>
+#include <deque>
+#include <stack>
+#include <string>
+
+#include "Benchmark.h"
+#include "CharSource.h"
+
+class CharSourceBench {
+	/*
+	 * The character source bookkeeping used before the circular
+	 * window: a pushback stack and a rewind queue, over a buffer.
+	 */
+	class StackDequeSource {
+		const char *cur, *end;
+		std::stack<char> pushed_char;
+		std::deque<char> returned_char;
+		int newlines;
+		static const size_t MAX_REWIND = 10;
+	public:
+		StackDequeSource(const std::string &s) :
+			cur(s.data()), end(s.data() + s.size()), newlines(0) {}
+
+		bool get(char &c) {
+			if (pushed_char.empty()) {
+				do {
+					if (cur == end) {
+						c = 0;
+						return false;
+					}
+					c = *cur++;
+				} while (c < 0 || c > 127);
+			} else {
+				c = pushed_char.top();
+				pushed_char.pop();
+			}
+			if (c == '\n')
+				newlines++;
+			returned_char.push_back(c);
+			while (returned_char.size() > MAX_REWIND)
+				returned_char.pop_front();
+			return true;
+		}
+
+		char char_after() {
+			char c;
+			if (get(c)) {
+				push(c);
+				return c;
+			} else
+				return 0;
+		}
+
+		char char_before(int n = 1) {
+			int index = returned_char.size() - n - 1;
+
+			return index >= 0 ? returned_char[index] : 0;
+		}
+
+		void push(char c) {
+			if (c == '\n')
+				newlines--;
+			pushed_char.push(c);
+			if (returned_char.size() > 0)
+				returned_char.pop_back();
+		}
+	};
+
+	// Access characters in the way a typical tokenizer does
+	template <typename S>
+	static size_t lex(S &s) {
+		size_t n = 0;
+		char c;
+
+		while (s.get(c)) {
+			n += c;
+			if (isalnum(c)) {
+				// Identifier: read it and push back its terminator
+				while (s.get(c) && isalnum(c))
+					n++;
+				s.push(c);
+			} else if (c == '/' || c == '<' || c == '>' || c == '=')
+				n += s.char_after();
+			else if (c == '\n')
+				n += s.char_before();
+		}
+		return n;
+	}
+public:
+	static void run() {
+		std::string code(Benchmark::source_code(64 * 1024 * 1024));
+
+		double before = Benchmark::run("CharSource stack and deque",
+			code.size(), "byte", [&code]() {
+				StackDequeSource s(code);
+				return lex(s);
+			});
+		double after = Benchmark::run("CharSource circular window",
+			code.size(), "byte", [&code]() {
+				CharSource s(code.data(), code.size());
+				return lex(s);
+			});
+		Benchmark::speedup(before, after);
+	}
+};
+#endif /* CHARSOURCEBENCH_H */
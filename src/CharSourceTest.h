@@ -1,6 +1,8 @@
 #ifndef CHARSOURCETEST_H
 #define CHARSOURCETEST_H
 
+#include <cstdint>
+#include <cstdio>
 #include <sstream>
 
 #include <cppunit/extensions/HelperMacros.h>
@@ -16,12 +18,31 @@ class CharSourceTest : public CppUnit::TestFixture  {
 	CPPUNIT_TEST(testNchar);
 	CPPUNIT_TEST(testNcharPush);
 	CPPUNIT_TEST(testCharAfter);
+	CPPUNIT_TEST(testPeek);
 	CPPUNIT_TEST(testCharBefore);
 	CPPUNIT_TEST(testCharBeforeN);
 	CPPUNIT_TEST(testCharBeforeNewline);
 	CPPUNIT_TEST(testCharBeforePush);
 	CPPUNIT_TEST(testCharBeforeQueueShrink);
 	CPPUNIT_TEST(testNewlines);
+	CPPUNIT_TEST(testPushNonAscii);
+	CPPUNIT_TEST(testNonAsciiRuns);
+	CPPUNIT_TEST(testPushDifferent);
+	CPPUNIT_TEST(testPushMany);
+	CPPUNIT_TEST(testBuffer);
+	CPPUNIT_TEST(testFile);
+	CPPUNIT_TEST(testEmptyFile);
+	CPPUNIT_TEST(testSkipTo);
+	CPPUNIT_TEST(testSkipToBlocks);
+	CPPUNIT_TEST(testSkipToPushed);
+	CPPUNIT_TEST(testGetWord);
+	CPPUNIT_TEST(testGetWordBlocks);
+	CPPUNIT_TEST(testGetWordPushed);
+	CPPUNIT_TEST(testViewWord);
+	CPPUNIT_TEST(testViewWordFallback);
+	CPPUNIT_TEST(testAddress);
+	CPPUNIT_TEST(testAddressBlocks);
+	CPPUNIT_TEST(testContents);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void testCtor() {
@@ -90,7 +111,7 @@ public:
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), 'h');
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), 'e');
 		CPPUNIT_ASSERT(!s.get(c));
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 2);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(2));
 	}
 
 	void testNcharPush() {
@@ -99,13 +120,13 @@ public:
 		CharSource s(str);
 		char c;
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), 'h');
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 1);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(1));
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), 'e');
 		s.push('e');
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 1);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(1));
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), 'e');
 		CPPUNIT_ASSERT(!s.get(c));
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 2);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(2));
 	}
 
 	void testCharAfter() {
@@ -123,7 +144,24 @@ public:
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), 'e');
 		CPPUNIT_ASSERT(!s.get(c));
 		CPPUNIT_ASSERT_EQUAL(s.char_after(), '\0');
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 2);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(2));
+	}
+
+	void testPeek() {
+		std::stringstream str("h\xc3\xa9" "e");
+
+		CharSource s(str);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('h', s.peek());
+		CPPUNIT_ASSERT_EQUAL('h', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('e', s.peek());
+		s.push('p');
+		CPPUNIT_ASSERT_EQUAL('p', s.peek());
+		CPPUNIT_ASSERT_EQUAL('p', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('e', s.peek());
+		CPPUNIT_ASSERT_EQUAL('e', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('\0', s.peek());
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), s.line_number());
 	}
 
 	void testCharBefore() {
@@ -142,7 +180,7 @@ public:
 		CPPUNIT_ASSERT_EQUAL(s.char_before(), 'h');
 		CPPUNIT_ASSERT(!s.get(c));
 		CPPUNIT_ASSERT_EQUAL(s.char_after(), '\0');
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 2);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(2));
 	}
 
 	void testCharBeforeNewline() {
@@ -182,7 +220,7 @@ public:
 		CPPUNIT_ASSERT_EQUAL(s.char_before(), 'h');
 		CPPUNIT_ASSERT(!s.get(c));
 		CPPUNIT_ASSERT_EQUAL(s.char_after(), '\0');
-		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), 2);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(2));
 	}
 
 	void testCharBeforeN() {
@@ -226,12 +264,320 @@ public:
 		CharSource s(str);
 		char c;
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), '1');
-		CPPUNIT_ASSERT_EQUAL(s.line_number(), 1);
+		CPPUNIT_ASSERT_EQUAL(s.line_number(), static_cast<uint64_t>(1));
 
 		CPPUNIT_ASSERT_EQUAL((s.get(c), c), '\n');
-		CPPUNIT_ASSERT_EQUAL(s.line_number(), 2);
+		CPPUNIT_ASSERT_EQUAL(s.line_number(), static_cast<uint64_t>(2));
 		s.push('\n');
-		CPPUNIT_ASSERT_EQUAL(s.line_number(), 1);
+		CPPUNIT_ASSERT_EQUAL(s.line_number(), static_cast<uint64_t>(1));
+	}
+
+	void testPushNonAscii() {
+		std::stringstream str("h\x80\xffi\xc3\xa9");
+
+		CharSource s(str);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('h', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('i', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(4));
+		s.push('i');
+		s.push('h');
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(2));
+		CPPUNIT_ASSERT_EQUAL('h', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('i', (s.get(c), c));
+		CPPUNIT_ASSERT(!s.get(c));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(6));
+	}
+
+	// Runs of non-ASCII characters longer than a vector register
+	void testNonAsciiRuns() {
+		std::string input;
+		for (int i = 0; i < 40; i++)
+			input += std::string(i, '\xe2') + (char)('0' + i) + '\n';
+		input += std::string(70, '\x9f');
+
+		CharSource s(input.data(), input.size());
+		char c;
+		for (int i = 0; i < 40; i++) {
+			CPPUNIT_ASSERT_EQUAL((char)('0' + i), (s.get(c), c));
+			CPPUNIT_ASSERT_EQUAL('\n', (s.get(c), c));
+		}
+		CPPUNIT_ASSERT_EQUAL(s.line_number(),
+			static_cast<uint64_t>(41));
+		CPPUNIT_ASSERT(!s.get(c));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(),
+			static_cast<uint64_t>(input.size()));
+	}
+
+	// Mix characters pushed back from the input with others
+	void testPushDifferent() {
+		std::stringstream str("abc");
+
+		CharSource s(str);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('b', (s.get(c), c));
+		s.push('b');
+		s.push('x');
+		s.push('a');
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('x', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('b', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('c', (s.get(c), c));
+		CPPUNIT_ASSERT(!s.get(c));
+	}
+
+	// Push back more characters than are kept for char_before()
+	void testPushMany() {
+		std::stringstream str("ab");
+
+		CharSource s(str);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		for (char i = 'c'; i < 'w'; i++)
+			s.push(i);
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), '\0');
+		for (char i = 'v'; i >= 'c'; i--)
+			CPPUNIT_ASSERT_EQUAL(i, (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), 'd');
+		CPPUNIT_ASSERT_EQUAL(s.char_before(9), 'l');
+		CPPUNIT_ASSERT_EQUAL(s.char_before(10), '\0');
+		CPPUNIT_ASSERT_EQUAL('b', (s.get(c), c));
+		CPPUNIT_ASSERT(!s.get(c));
+	}
+
+	void testBuffer() {
+		const char buff[] = "h\xc3\xa9i";
+
+		CharSource s(buff, sizeof(buff) - 1);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('h', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('i', (s.get(c), c));
+		s.push('i');
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), '\0');
+		CPPUNIT_ASSERT_EQUAL('i', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), 'h');
+		CPPUNIT_ASSERT(!s.get(c));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(4));
+	}
+
+	void testFile() {
+		FILE *f = tmpfile();
+		fputs("h\ne", f);
+		fflush(f);
+
+		CharSource s(fileno(f));
+		char c;
+		CPPUNIT_ASSERT_EQUAL('h', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('\n', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.line_number(), static_cast<uint64_t>(2));
+		s.push('\n');
+		CPPUNIT_ASSERT_EQUAL(s.line_number(), static_cast<uint64_t>(1));
+		CPPUNIT_ASSERT_EQUAL('\n', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), 'h');
+		CPPUNIT_ASSERT_EQUAL('e', (s.get(c), c));
+		CPPUNIT_ASSERT(!s.get(c));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(3));
+		fclose(f);
+	}
+
+	void testEmptyFile() {
+		FILE *f = tmpfile();
+
+		CharSource s(fileno(f));
+		char c;
+		CPPUNIT_ASSERT(!s.get(c));
+		CPPUNIT_ASSERT_EQUAL(s.char_after(), '\0');
+		fclose(f);
+	}
+
+	void testSkipTo() {
+		const char buff[] = "a\nb\xc3\xa9\nc*d";
+
+		CharSource s(buff, sizeof(buff) - 1);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		s.skip_to('*', '*');
+		CPPUNIT_ASSERT_EQUAL(s.line_number(), static_cast<uint64_t>(3));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(7));
+		CPPUNIT_ASSERT_EQUAL('*', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), '\0');
+		CPPUNIT_ASSERT_EQUAL('d', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL(s.char_before(), '*');
+		s.skip_to('*', '*');
+		CPPUNIT_ASSERT(!s.get(c));
+	}
+
+	// Skip over the boundaries of the blocks read from a stream
+	void testSkipToBlocks() {
+		std::string data;
+		for (int i = 0; i < 200000; i++)
+			data += "x\n";
+		data += "\"y";
+		std::stringstream str(data);
+
+		CharSource s(str);
+		char c;
+		s.skip_to('"', '\\');
+		CPPUNIT_ASSERT_EQUAL(s.line_number(),
+			static_cast<uint64_t>(200001));
+		CPPUNIT_ASSERT_EQUAL('"', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('y', (s.get(c), c));
+		s.push('y');
+		CPPUNIT_ASSERT_EQUAL('y', (s.get(c), c));
+		CPPUNIT_ASSERT(!s.get(c));
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(),
+			static_cast<uint64_t>(400002));
+	}
+
+	void testSkipToPushed() {
+		std::stringstream str("ab*");
+
+		CharSource s(str);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		s.push('a');
+		s.skip_to('*', '*');
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		s.skip_to('*', '*');
+		CPPUNIT_ASSERT_EQUAL('*', (s.get(c), c));
+	}
+
+	void testGetWord() {
+		const char buff[] = "ab\xc3\xa9" "c_1+d";
+
+		CharSource s(buff, sizeof(buff) - 1);
+		std::string val;
+		char c;
+		s.get_word(val, ByteScan::WordChars('_'));
+		CPPUNIT_ASSERT_EQUAL(std::string("abc_1"), val);
+		CPPUNIT_ASSERT_EQUAL(s.get_nchar(), static_cast<uint64_t>(7));
+		CPPUNIT_ASSERT_EQUAL('+', (s.get(c), c));
+		s.get_word(val, ByteScan::WordChars('_'));
+		CPPUNIT_ASSERT_EQUAL(std::string("abc_1d"), val);
+		CPPUNIT_ASSERT(!s.get(c));
+	}
+
+	// Words spanning the boundaries of the blocks read from a stream
+	void testGetWordBlocks() {
+		std::string data(300000, 'x');
+		data += ";";
+		std::stringstream str(data);
+
+		CharSource s(str);
+		std::string val;
+		char c;
+		s.get_word(val, ByteScan::WordChars('_'));
+		CPPUNIT_ASSERT_EQUAL(300000, static_cast<int>(val.size()));
+		CPPUNIT_ASSERT_EQUAL(';', (s.get(c), c));
+		s.push(';');
+		CPPUNIT_ASSERT_EQUAL(';', (s.get(c), c));
+		CPPUNIT_ASSERT(!s.get(c));
+	}
+
+	void testGetWordPushed() {
+		std::stringstream str("ab-");
+
+		CharSource s(str);
+		std::string val;
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		s.push('a');
+		s.get_word(val, ByteScan::WordChars('_'));
+		CPPUNIT_ASSERT_EQUAL(std::string("ab"), val);
+		CPPUNIT_ASSERT_EQUAL('-', (s.get(c), c));
+	}
+
+	void testViewWord() {
+		const char data[] = "ab_c+d";
+
+		CharSource s(data, sizeof(data) - 1);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		std::string_view v(s.view_word(c, ByteScan::WordChars('_')));
+		CPPUNIT_ASSERT_EQUAL(std::string("ab_c"), std::string(v));
+		CPPUNIT_ASSERT(v.data() == data);
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(4), s.get_nchar());
+		CPPUNIT_ASSERT_EQUAL('+', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('d', (s.get(c), c));
+		v = s.view_word(c, ByteScan::WordChars('_'));
+		CPPUNIT_ASSERT_EQUAL(std::string("d"), std::string(v));
+		CPPUNIT_ASSERT(!s.get(c));
+	}
+
+	void testViewWordFallback() {
+		const char data[] = "ab c\xc3\xa9" "d";
+		char c;
+
+		// Pushed back characters
+		CharSource s(data, sizeof(data) - 1);
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		s.push(c);
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		s.push('b');
+		CPPUNIT_ASSERT(s.view_word(c, ByteScan::WordChars('_')).empty());
+		CPPUNIT_ASSERT_EQUAL('b', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('b', (s.get(c), c));
+
+		// Non-ASCII characters
+		CPPUNIT_ASSERT_EQUAL(' ', (s.get(c), c));
+		CPPUNIT_ASSERT_EQUAL('c', (s.get(c), c));
+		CPPUNIT_ASSERT(s.view_word(c, ByteScan::WordChars('_')).empty());
+		CPPUNIT_ASSERT_EQUAL('d', (s.get(c), c));
+
+		// Input read in blocks
+		std::stringstream str("ab");
+		CharSource b(str);
+		CPPUNIT_ASSERT_EQUAL('a', (b.get(c), c));
+		CPPUNIT_ASSERT(b.view_word(c, ByteScan::WordChars('_')).empty());
+		CPPUNIT_ASSERT_EQUAL('b', (b.get(c), c));
+	}
+
+	void testAddress() {
+		const char data[] = "ab\ncd";
+
+		CharSource s(data, sizeof(data) - 1);
+		char c;
+		CPPUNIT_ASSERT_EQUAL('a', (s.get(c), c));
+		CPPUNIT_ASSERT(s.address(0) == data);
+		CPPUNIT_ASSERT(s.address(3) == data + 3);
+		CPPUNIT_ASSERT(s.address(5) == data + 5);
+		CPPUNIT_ASSERT(s.address(6) == nullptr);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), s.offset(data + 4));
+	}
+
+	// Offsets count from the input's start across buffer fills
+	void testAddressBlocks() {
+		std::string data(300000, 'x');
+		data += ";";
+		std::stringstream str(data);
+
+		CharSource s(str);
+		std::string val;
+		char c;
+		s.get_word(val, ByteScan::WordChars('_'));
+		CPPUNIT_ASSERT(s.address(0) == nullptr);
+		const char *p = s.address(s.get_nchar());
+		CPPUNIT_ASSERT(p != nullptr);
+		CPPUNIT_ASSERT_EQUAL(';', *p);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(300000), s.offset(p));
+		CPPUNIT_ASSERT_EQUAL(';', (s.get(c), c));
+	}
+
+	void testContents() {
+		const char data[] = "ab";
+		char c;
+
+		CharSource s(data, sizeof(data) - 1);
+		CPPUNIT_ASSERT(s.contents().data() == data);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), s.contents().size());
+		s.get(c);
+		CPPUNIT_ASSERT(s.contents().empty());
+
+		// Input read in blocks isn't available in advance
+		std::stringstream str("ab");
+		CharSource b(str);
+		CPPUNIT_ASSERT(b.contents().empty());
 	}
 };
 #endif /*  CHARSOURCETEST_H */
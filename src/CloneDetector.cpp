@@ -0,0 +1,132 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <tuple>
+
+#include "CloneDetector.h"
+
+// Multiplier of the rolling hash of unit runs; odd
+static const uint64_t ROLLING_BASE = 0x100000001b3ULL;
+
+CloneDetector::CloneDetector(unsigned m) : min_tokens(m), starts{0}
+{
+}
+
+void
+CloneDetector::add_file(const std::string &name, FileUnits &f)
+{
+	f.end_unit();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	names.push_back(name);
+	units.insert(units.end(), f.units.begin(), f.units.end());
+	starts.push_back(units.size());
+	f.units.clear();
+}
+
+/*
+ * Files are processed in the order of their names, so that the
+ * clones are reported in the same order, whatever the order
+ * in which the files were added.
+ */
+void
+CloneDetector::detect(const std::function<void(const Clone &)> &report) const
+{
+	// A run of units spanning the minimum number of tokens
+	struct Seed {
+		uint64_t hash;		// Rolling hash of its units
+		size_t rank;		// Its file's position in name order
+		size_t unit;		// Its first unit
+	};
+	std::vector<Seed> seeds;
+
+	std::vector<size_t> order(names.size());
+	for (size_t f = 0; f < order.size(); f++)
+		order[f] = f;
+	std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+		return names[a] < names[b];
+	});
+
+	// Prefix hashes of a file's units, and powers of the base
+	std::vector<uint64_t> prefix, power{1};
+	for (size_t r = 0; r < order.size(); r++) {
+		size_t begin = starts[order[r]], end = starts[order[r] + 1];
+
+		prefix.assign(1, 0);
+		for (size_t i = begin; i < end; i++) {
+			prefix.push_back(prefix.back() * ROLLING_BASE +
+				units[i].hash);
+			if (power.size() < prefix.size())
+				power.push_back(power.back() * ROLLING_BASE);
+		}
+
+		// Find the shortest run [i, k) starting at each unit i
+		size_t k = begin;
+		uint64_t ntokens = 0;
+		for (size_t i = begin; i < end; i++) {
+			while (k < end && ntokens < min_tokens)
+				ntokens += units[k++].ntokens;
+			if (ntokens < min_tokens)
+				break;
+			uint64_t h = prefix[k - begin] -
+				prefix[i - begin] * power[k - i];
+			seeds.push_back({h, r, i});
+			ntokens -= units[i].ntokens;
+		}
+	}
+
+	std::sort(seeds.begin(), seeds.end(), [](const Seed &a, const Seed &b) {
+		return std::tie(a.hash, a.rank, a.unit) <
+			std::tie(b.hash, b.rank, b.unit);
+	});
+
+	for (size_t g = 0, h; g < seeds.size(); g = h) {
+		for (h = g + 1; h < seeds.size() &&
+		    seeds[h].hash == seeds[g].hash; h++)
+			;
+		for (size_t x = g; x < h; x++)
+			for (size_t y = x + 1; y < h; y++) {
+				size_t a = seeds[x].unit, fa = order[seeds[x].rank];
+				size_t b = seeds[y].unit, fb = order[seeds[y].rank];
+
+				// Skip clones continuing from the preceding units
+				if (a > starts[fa] && b > starts[fb] &&
+				    units[a - 1].hash == units[b - 1].hash)
+					continue;
+
+				// Extend the clone, without overlapping itself
+				size_t a_end = starts[fa + 1];
+				if (fa == fb)
+					a_end = std::min(a_end, b);
+				size_t b_end = starts[fb + 1];
+				size_t len = 0;
+				uint64_t ntokens = 0;
+				while (a + len < a_end && b + len < b_end &&
+				    units[a + len].hash == units[b + len].hash)
+					ntokens += units[a + len++].ntokens;
+				if (len == 0 || ntokens < min_tokens)
+					continue;
+
+				const Unit &la = units[a + len - 1];
+				const Unit &lb = units[b + len - 1];
+				report({{&names[fa], &names[fb]},
+					{units[a].line, units[b].line},
+					{la.end, lb.end},
+					ntokens});
+			}
+	}
+}
@@ -0,0 +1,118 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef CLONEDETECTOR_H
+#define CLONEDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TokenId.h"
+
+/**
+ * Detect clones: sequences of consecutive units (e.g. lines) whose
+ * tokens appear identically in two places, spanning at least a
+ * minimum number of tokens.
+ * Each unit is represented by the hash of its tokens.
+ * The runs of units spanning the minimum number of tokens that start
+ * at each unit are hashed with a rolling hash and sorted, so that
+ * runs occurring in several places are grouped together.
+ * Each pair of places in a group that doesn't continue a clone
+ * starting at the preceding units is then extended over the
+ * following identical units.
+ */
+class CloneDetector {
+public:
+	// A unit of tokens
+	struct Unit {
+		uint64_t hash;		// Hash of its tokens
+		uint64_t line;		// Line of its first token
+		uint64_t end;		// Line of its last token
+		uint32_t ntokens;	// Number of tokens
+	};
+
+	// The units of a file, built as its tokens are added
+	class FileUnits {
+		std::vector<Unit> units;
+		Unit unit;		// Unit being built
+		uint64_t h;		// Its hash state
+		friend class CloneDetector;
+	public:
+		FileUnits() : unit{0, 0, 0, 0}, h(0) {}
+
+		// Add a token that ends in the specified line
+		void add(token_type t, uint64_t line) {
+			if (unit.ntokens == 0) {
+				unit.line = line;
+				h = 0xcbf29ce484222325ULL;
+			}
+			h = (h ^ t) * 0x9e3779b97f4a7c15ULL;
+			h ^= h >> 32;
+			unit.end = line;
+			unit.ntokens++;
+		}
+
+		// End the current unit; empty units are ignored
+		void end_unit() {
+			if (unit.ntokens == 0)
+				return;
+			unit.hash = h;
+			units.push_back(unit);
+			unit.ntokens = 0;
+		}
+	};
+
+	// A pair of places containing the same units
+	struct Clone {
+		const std::string *file[2];	// Names of the files
+		uint64_t begin[2];		// First line in each file
+		uint64_t end[2];		// Last line in each file
+		uint64_t ntokens;		// Number of tokens
+	};
+private:
+	unsigned min_tokens;		// Minimum number of tokens in a clone
+	std::vector<std::string> names;	// Name of each file
+	/*
+	 * Index in units of each file's first unit,
+	 * followed by the number of units.
+	 */
+	std::vector<size_t> starts;
+	std::vector<Unit> units;	// The units of all files
+	std::mutex mutex;		// Protects the above when adding files
+public:
+	// Detect clones with at least the specified number of tokens
+	CloneDetector(unsigned min_tokens);
+
+	/**
+	 * Add the units of the named file, leaving f empty.
+	 * Files can be added concurrently.
+	 */
+	void add_file(const std::string &name, FileUnits &f);
+
+	/**
+	 * Call report with each clone pair.
+	 * The first place of each pair comes before the second one
+	 * in the order of the files' names and lines.
+	 * Clones are reported as they are found, in an order that
+	 * only depends on the files' names and contents.
+	 */
+	void detect(const std::function<void(const Clone &)> &report) const;
+};
+#endif /* CLONEDETECTOR_H */
@@ -0,0 +1,155 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef CLONEDETECTORTEST_H
+#define CLONEDETECTORTEST_H
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CloneDetector.h"
+#include "CTokenizer.h"
+
+class CloneDetectorTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CloneDetectorTest);
+	CPPUNIT_TEST(testPair);
+	CPPUNIT_TEST(testMinTokens);
+	CPPUNIT_TEST(testMaximal);
+	CPPUNIT_TEST(testOverlap);
+	CPPUNIT_TEST(testFileOrder);
+	CPPUNIT_TEST(testTokenize);
+	CPPUNIT_TEST_SUITE_END();
+
+	/*
+	 * Add to d a file with one unit on each line for each string,
+	 * containing a token for each of its characters.
+	 */
+	static void add(CloneDetector &d, const std::string &name,
+			const std::vector<std::string> &lines) {
+		CloneDetector::FileUnits f;
+
+		for (size_t i = 0; i < lines.size(); i++) {
+			for (char c : lines[i])
+				f.add(c, i + 1);
+			f.end_unit();
+		}
+		d.add_file(name, f);
+	}
+
+	// Return the clones that d detects as sorted lines of text
+	static std::string clones(const CloneDetector &d) {
+		std::vector<std::string> lines;
+
+		d.detect([&lines](const CloneDetector::Clone &c) {
+			std::ostringstream s;
+			s << *c.file[0] << ':' << c.begin[0] << '-' <<
+				c.end[0] << ' ' << *c.file[1] << ':' <<
+				c.begin[1] << '-' << c.end[1] << ' ' <<
+				c.ntokens << '\n';
+			lines.push_back(s.str());
+		});
+		std::sort(lines.begin(), lines.end());
+		std::string result;
+		for (auto &l : lines)
+			result += l;
+		return result;
+	}
+
+	// Return the clones in the order d detects them
+	static std::string unsorted_clones(const CloneDetector &d) {
+		std::ostringstream s;
+
+		d.detect([&s](const CloneDetector::Clone &c) {
+			s << *c.file[0] << c.begin[0] << *c.file[1] <<
+				c.begin[1] << '\n';
+		});
+		return s.str();
+	}
+public:
+	void testPair() {
+		CloneDetector d(4);
+
+		add(d, "a", {"x", "abc", "de", "y"});
+		add(d, "b", {"abc", "de"});
+		CPPUNIT_ASSERT_EQUAL(std::string("a:2-3 b:1-2 5\n"),
+			clones(d));
+	}
+
+	void testMinTokens() {
+		CloneDetector d(6);
+
+		add(d, "a", {"x", "abc", "de", "y"});
+		add(d, "b", {"abc", "de"});
+		CPPUNIT_ASSERT_EQUAL(std::string(), clones(d));
+	}
+
+	// Clones are reported once, covering all their identical units
+	void testMaximal() {
+		CloneDetector d(2);
+
+		add(d, "a", {"ab", "cd", "ef", "gh", "z"});
+		add(d, "b", {"y", "ab", "cd", "ef", "gh"});
+		add(d, "c", {"cd", "ef"});
+		CPPUNIT_ASSERT_EQUAL(std::string(
+			"a:1-4 b:2-5 8\n"
+			"a:2-3 c:1-2 4\n"
+			"b:3-4 c:1-2 4\n"), clones(d));
+	}
+
+	// Clones within a file don't overlap themselves
+	void testOverlap() {
+		CloneDetector d(4);
+
+		add(d, "a", {"ab", "ab", "ab", "ab", "ab"});
+		CPPUNIT_ASSERT_EQUAL(std::string(
+			"a:1-2 a:3-4 4\n"
+			"a:1-2 a:4-5 4\n"), clones(d));
+	}
+
+	// The order in which files are added doesn't matter
+	void testFileOrder() {
+		CloneDetector d1(3), d2(3);
+
+		add(d1, "a", {"abc", "x", "def"});
+		add(d1, "b", {"def", "abc"});
+		add(d2, "b", {"def", "abc"});
+		add(d2, "a", {"abc", "x", "def"});
+		CPPUNIT_ASSERT_EQUAL(unsorted_clones(d1), unsorted_clones(d2));
+		CPPUNIT_ASSERT(clones(d1).find("a:1-1 b:2-2 3\n") !=
+			std::string::npos);
+	}
+
+	// Units are those of the binary output
+	void testTokenize() {
+		CloneDetector d(8);
+		CloneDetector::FileUnits f1, f2;
+		CTokenizer t1("int a;\n\nint f()\n{\n\treturn a + 1;\n}\n",
+			{"line"});
+		CTokenizer t2("int g()\n{\n\treturn y + 2;\n}\n", {"line"});
+
+		t1.clone_tokenize(f1, true);
+		t2.clone_tokenize(f2, true);
+		d.add_file("a.c", f1);
+		d.add_file("b.c", f2);
+		CPPUNIT_ASSERT_EQUAL(std::string("a.c:3-6 b.c:1-4 11\n"),
+			clones(d));
+	}
+};
+#endif /* CLONEDETECTORTEST_H */
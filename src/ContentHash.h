@@ -0,0 +1,121 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ * Calculate a 128-bit hash value identifying a file's contents.
+ * The value consists of two XXH64 hashes with different seeds,
+ * which process the data eight bytes at a time, so that
+ * the contents of large files can be identified far faster than
+ * they can be tokenized.
+ * Values are the same across runs and platforms.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+class ContentHash {
+	static constexpr uint64_t P1 = 0x9e3779b185ebca87ull;
+	static constexpr uint64_t P2 = 0xc2b2ae3d27d4eb4full;
+	static constexpr uint64_t P3 = 0x165667b19e3779f9ull;
+	static constexpr uint64_t P4 = 0x85ebca77c2b2ae63ull;
+	static constexpr uint64_t P5 = 0x27d4eb2f165667c5ull;
+
+	static uint64_t rotl(uint64_t x, int r) {
+		return (x << r) | (x >> (64 - r));
+	}
+
+	// Little-endian reads, regardless of the platform
+	static uint64_t read64(const unsigned char *p) {
+		uint64_t v = 0;
+		for (int i = 7; i >= 0; i--)
+			v = (v << 8) | p[i];
+		return v;
+	}
+
+	static uint32_t read32(const unsigned char *p) {
+		return p[0] | (p[1] << 8) | (p[2] << 16) |
+			(static_cast<uint32_t>(p[3]) << 24);
+	}
+
+	static uint64_t round(uint64_t acc, uint64_t input) {
+		acc += input * P2;
+		acc = rotl(acc, 31);
+		return acc * P1;
+	}
+
+	static uint64_t merge_round(uint64_t acc, uint64_t v) {
+		acc ^= round(0, v);
+		return acc * P1 + P4;
+	}
+public:
+	// Return the XXH64 hash of the specified data
+	static uint64_t xxh64(std::string_view data, uint64_t seed) {
+		auto p = reinterpret_cast<const unsigned char *>(data.data());
+		const unsigned char *end = p + data.size();
+		uint64_t h;
+
+		if (data.size() >= 32) {
+			uint64_t v1 = seed + P1 + P2;
+			uint64_t v2 = seed + P2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - P1;
+			for (; end - p >= 32; p += 32) {
+				v1 = round(v1, read64(p));
+				v2 = round(v2, read64(p + 8));
+				v3 = round(v3, read64(p + 16));
+				v4 = round(v4, read64(p + 24));
+			}
+			h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) +
+				rotl(v4, 18);
+			h = merge_round(h, v1);
+			h = merge_round(h, v2);
+			h = merge_round(h, v3);
+			h = merge_round(h, v4);
+		} else
+			h = seed + P5;
+
+		h += data.size();
+		for (; end - p >= 8; p += 8)
+			h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+		if (end - p >= 4) {
+			h = rotl(h ^ (read32(p) * P1), 23) * P2 + P3;
+			p += 4;
+		}
+		for (; p < end; p++)
+			h = rotl(h ^ (*p * P5), 11) * P1;
+
+		h ^= h >> 33;
+		h *= P2;
+		h ^= h >> 29;
+		h *= P3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	// Return the 128-bit hash of the data as 32 hexadecimal digits
+	static std::string hex(std::string_view data) {
+		static const char digits[] = "0123456789abcdef";
+		uint64_t h[2] = {xxh64(data, 0), xxh64(data, P3)};
+		std::string s;
+
+		for (uint64_t v : h)
+			for (int i = 60; i >= 0; i -= 4)
+				s += digits[(v >> i) & 0xf];
+		return s;
+	}
+};
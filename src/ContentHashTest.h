@@ -0,0 +1,73 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef CONTENTHASHTEST_H
+#define CONTENTHASHTEST_H
+
+#include <cstdint>
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ContentHash.h"
+
+class ContentHashTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(ContentHashTest);
+	CPPUNIT_TEST(testXxh64);
+	CPPUNIT_TEST(testLengths);
+	CPPUNIT_TEST(testHex);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	// Published XXH64 values
+	void testXxh64() {
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0xef46db3751d8e999),
+			ContentHash::xxh64("", 0));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0xd24ec4f1a98c6e5b),
+			ContentHash::xxh64("a", 0));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0x44bc2cf5ad770999),
+			ContentHash::xxh64("abc", 0));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0xfbcea83c8a378bf1),
+			ContentHash::xxh64(
+			"Nobody inspects the spammish repetition", 0));
+	}
+
+	// Lengths around the 32-byte block size, with a seed
+	void testLengths() {
+		std::string s;
+		for (int i = 0; i < 100; i++)
+			s += static_cast<char>(i * 7 + 3);
+		const uint64_t seed = 0x165667b19e3779f9ull;
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0xa2aa5f33cc4a6119),
+			ContentHash::xxh64(s.substr(0, 31), 0));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0x23c3c17ef790fd97),
+			ContentHash::xxh64(s.substr(0, 32), 0));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0x11a3ce2f9c8492b7),
+			ContentHash::xxh64(s.substr(0, 33), seed));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0x25720114fd65b876),
+			ContentHash::xxh64(s, seed));
+	}
+
+	void testHex() {
+		std::string h(ContentHash::hex("abc"));
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(32), h.size());
+		CPPUNIT_ASSERT_EQUAL(std::string("44bc2cf5ad770999"),
+			h.substr(0, 16));
+		CPPUNIT_ASSERT(h != ContentHash::hex("abd"));
+	}
+};
+#endif /* CONTENTHASHTEST_H */
@@ -24,17 +24,18 @@
 #include "CppTokenizer.h"
 #include "Token.h"
 
+template <bool AllContents>
 inline token_type
-CppTokenizer::get_immediate_token()
+CppTokenizer::lex_token()
 {
-	char c0, c1, c2;
+	char c0, c1;
 	Keyword::IdentifierType key;
 
 	for (;;) {
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -68,225 +69,41 @@ CppTokenizer::get_immediate_token()
 			 */
 			nesting.unsaw_class();
 			return static_cast<token_type>(c0);
-		/*
-		 * Double character C tokens with more than 2 different outcomes
-		 * (e.g. +, +=, ++)
-		 */
-		case '+':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '+':
-				return Token::PLUS_PLUS; // ++
-			case '=':
-				return Token::PLUS_EQUAL; // +=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '-':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '-':
-				return Token::MINUS_MINUS; // --
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			case '>':
-				src.get(c2);
-				if (c2 == '*')
-					return Token::MEMBER_PTR_FROM_OBJECT_PTR; // ->*
-				else {
-					src.push(c2);
-					return Token::RIGHT_SLIM_ARROW; // ->
-				}
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '&':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '&':
-				return Token::BOOLEAN_AND; // &&
-			case '=':
-				return Token::AND_EQUAL; // &=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '|':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '|':
-				return Token::BOOLEAN_OR; // ||
-			case '=':
-				return Token::OR_EQUAL; // |=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Simple single/double character tokens (e.g. !, !=) */
-		case '!':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::NOT_EQUAL; // !=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '%':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '*':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::TIMES_EQUAL; // *=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '=':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::EQUAL; // ==
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case ':':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == ':')
-				return Token::DOUBLE_COLON; // ::
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '^':
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case ':': case '<': case '=': case '^': case '|':
 			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_operator_token(c0, Operator::Cpp);
 		case '#':
-			src.get(c1);
-			if (c1 == '#')
-				return Token::TOKEN_PASTE; // ##
-			else
-				src.push(c1);
+			if (get_operator_token(c0, Operator::Cpp) == Token::TOKEN_PASTE)
+				return Token::TOKEN_PASTE;
 			if (bol.at_bol_space())
 				scan_cpp_directive = true;
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
-		/* Operators starting with < or > */
 		case '>':
 			bol.saw_non_space();
 			// class might have been used as a template argument
 			nesting.unsaw_class();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* >= */
-				return Token::GREATER_EQUAL; // >=
-			case '>':
-				src.get(c1);
-				if (c1 == '=')			/* >>= */
-					return Token::RSHIFT_EQUAL; // >>=
-				else {			/* << */
-					src.push(c1);
-					return Token::RSHIFT; // >>
-				}
-				break;
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '<':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* <= */
-				return Token::LESS_EQUAL; // <=
-			case '<':
-				src.get(c1);
-				if (c1 == '=')			/* <<= */
-					return Token::LSHIFT_EQUAL; // <<=
-				else {			/* << */
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-				break;
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_operator_token(c0, Operator::Cpp);
 		/* Comments and / operators */
 		case '/':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* /= */
-				return Token::DIV_EQUAL; // /=
+			switch (src.peek()) {
 			case '*':				/* Block comment */
-				return get_block_comment_token();
+				src.get(c1);
+				return get_block_comment_token<AllContents>();
 			case '/':				/* Line comment */
-				return get_line_comment_token();
-			default:				/* / */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+				src.get(c1);
+				return get_line_comment_token<AllContents>();
+			default:				/* / /= */
+				return get_operator_token(c0, Operator::Cpp);
 			}
-			break;
 		case '.':	/* . .* ... */
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '0': case '1': case '2': case '3': case '4':
-			case '5': case '6': case '7': case '8': case '9':
-				val = std::string(".") + (char)(c1);
-				return get_number_token(val);
-			case '.':
-				src.get(c2);
-				if (c2 == '.')
-					return Token::ELIPSIS; // ...
-				else {
-					src.push(c2);
-					src.push(c1);
-					return static_cast<token_type>(c0);
-				}
-				break;
-			case '*':
-				return Token::MEMBER_PTR_FROM_OBJECT; // .*
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			if (isdigit(src.peek()))
+				return get_number_token(c0);
+			return get_operator_token(c0, Operator::Cpp);
 		/* XXX Can also be non-ASCII */
 		case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
 		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k':
@@ -298,15 +115,8 @@ CppTokenizer::get_immediate_token()
 		case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
 		case 'V': case 'W': case 'X': case 'Y': case 'Z':
 			bol.saw_non_space();
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				if (!isalnum(c0) && c0 != '_')
-					break;
-				val += c0;
-			}
-			src.push(c0);
-			key = keyword.identifier_type(val);
+			get_word_value(c0, identifier_chars);
+			key = keyword.identifier_type(value);
 			switch (key) {
 			case Keyword::K_define:
 			case Keyword::K_elif:
@@ -322,10 +132,10 @@ CppTokenizer::get_immediate_token()
 					scan_cpp_directive = false;
 					return key;
 				} else
-					return symbols.value(val);
+					return symbols.value(value);
 				break;
 			case Keyword::FIRST_IDENTIFIER:
-				return symbols.value(val);
+				return symbols.value(value);
 			case Keyword::K_class:
 			case Keyword::K_struct:
 				nesting.saw_class();
@@ -359,13 +169,13 @@ CppTokenizer::get_immediate_token()
 			break;
 		case '\'':
 			bol.saw_non_space();
-			if (process_char_literal())
+			if (process_char_literal<AllContents>())
 				return Token::CHAR_LITERAL; // '.'
 			else
 				return 0;
 		case '"':
 			bol.saw_non_space();
-			if (process_string_literal())
+			if (process_string_literal<AllContents>())
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
@@ -373,8 +183,7 @@ CppTokenizer::get_immediate_token()
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
 			bol.saw_non_space();
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
@@ -385,3 +194,7 @@ CppTokenizer::get_immediate_token()
 CppTokenizer::~CppTokenizer()
 {
 }
+
+template token_type CppTokenizer::lex_token<false>();
+template token_type CppTokenizer::lex_token<true>();
+template class TokenizerImpl<CppTokenizer>;
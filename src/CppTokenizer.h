@@ -24,15 +24,16 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class CppTokenizer : public TokenizerBase {
+class CppTokenizer : public TokenizerImpl<CppTokenizer> {
 private:
 	bool scan_cpp_directive;	// Keyword after a C preprocessor #
 	Token cpp_token;
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -49,14 +50,15 @@ public:
 	// Construct from a character source
 	CppTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Cpp, s, file_name, opt), scan_cpp_directive(false) {}
+		TokenizerImpl(Keyword::L_Cpp, s, file_name, opt), scan_cpp_directive(false) {}
 
 	// Construct for a string source
 	CppTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Cpp, s, opt), scan_cpp_directive(false) {}
+		TokenizerImpl(Keyword::L_Cpp, s, opt), scan_cpp_directive(false) {}
 
 	~CppTokenizer();
 
 	friend class CppTokenizerTest;
 };
+extern template class TokenizerImpl<CppTokenizer>;
 #endif /* CPPTOKENIZER_H */
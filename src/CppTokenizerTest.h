@@ -20,6 +20,7 @@ class CppTokenizerTest : public CppUnit::TestFixture  {
 	CPPUNIT_TEST(testBOOLEAN_OR);
 	CPPUNIT_TEST(testDIV_EQUAL);
 	CPPUNIT_TEST(testELIPSIS);
+	CPPUNIT_TEST(testDotDot);
 	CPPUNIT_TEST(testEQUAL);
 	CPPUNIT_TEST(testGREATER_EQUAL);
 	CPPUNIT_TEST(testLESS_EQUAL);
@@ -131,6 +132,14 @@ public:
 		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(Token::ELIPSIS), ct.get_token());
 	}
 
+	// A prefix of a longer operator is returned as separate tokens
+	void testDotDot() {
+		CppTokenizer ct("..3");
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>('.'), ct.get_token());
+		CPPUNIT_ASSERT(TokenId::is_number(ct.get_token()));
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(0), ct.get_token());
+	}
+
 	void testEQUAL() {
 		CppTokenizer ct("==2");
 		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(Token::EQUAL), ct.get_token());
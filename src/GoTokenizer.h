@@ -24,15 +24,16 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class GoTokenizer : public TokenizerBase {
+class GoTokenizer : public TokenizerImpl<GoTokenizer> {
 private:
 	/** True for keywords that don't end with semicolon */
 	Token ctoken;
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -49,12 +50,13 @@ public:
 	// Construct from a character source
 	GoTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Go, s, file_name, opt) {}
+		TokenizerImpl(Keyword::L_Go, s, file_name, opt) {}
 
 	// Construct for a string source
 	GoTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Go, s, opt) {}
+		TokenizerImpl(Keyword::L_Go, s, opt) {}
 
 	~GoTokenizer();
 };
+extern template class TokenizerImpl<GoTokenizer>;
 #endif /* GOTOKENIZER_H */
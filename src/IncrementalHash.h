@@ -13,39 +13,58 @@
  *   See the License for the specific language governing permissions and
  *   limitations under the License.
  *
- * Calculate the hash value of an accumulated string
+ * Calculate the hash value of a sequence of characters and tokens
+ * as they are added, using constant memory.
+ * The hash is the 64-bit FNV-1a hash of the sequence's bytes,
+ * finalized with the MurmurHash3 mixer, so that its value is the same
+ * across runs and platforms.
  */
 
 #pragma once
 
-#include <string>
-#include <functional>
+#include <cstdint>
 
 #include "TokenId.h"
 
 class IncrementalHash {
-	static const size_t RESERVE_SIZE = 4096;
+	static constexpr uint64_t OFFSET_BASIS = 14695981039346656037ull;
+	static constexpr uint64_t PRIME = 1099511628211ull;
+	/*
+	 * Byte preceding the bytes of tokens, distinguishing them from
+	 * characters, which are ASCII.
+	 */
+	static constexpr unsigned char TOKEN_MARK = 0xff;
 
-	std::string buffer;
-	std::hash<std::string> hasher;
-public:
-	IncrementalHash() {
-		buffer.reserve(RESERVE_SIZE);
+	uint64_t h;
+
+	void add_byte(unsigned char b) {
+		h = (h ^ b) * PRIME;
 	}
+public:
+	IncrementalHash() : h(OFFSET_BASIS) {}
 
 	void add(char c) {
-		buffer.push_back(c);
+		add_byte(c);
 	}
 
 	void add(token_type t) {
-		buffer.append(std::to_string(t));
+		add_byte(TOKEN_MARK);
+		for (unsigned i = 0; i < sizeof(t); i++, t >>= 8)
+			add_byte(t & 0xff);
 	}
 
-	token_type get() {
-		return static_cast<token_type>(hasher(buffer)) | TokenId::HASHED_CONTENT ;
+	token_type get() const {
+		uint64_t x = h;
+
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return static_cast<token_type>(x) | TokenId::HASHED_CONTENT;
 	}
 
 	void reset() {
-		buffer.clear();
+		h = OFFSET_BASIS;
 	}
 };
@@ -0,0 +1,89 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef INCREMENTALHASHTEST_H
+#define INCREMENTALHASHTEST_H
+
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "IncrementalHash.h"
+#include "TokenId.h"
+
+class IncrementalHashTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(IncrementalHashTest);
+	CPPUNIT_TEST(testStable);
+	CPPUNIT_TEST(testReset);
+	CPPUNIT_TEST(testToken);
+	CPPUNIT_TEST(testLong);
+	CPPUNIT_TEST_SUITE_END();
+
+	static void add(IncrementalHash &h, const std::string &s) {
+		for (char c : s)
+			h.add(c);
+	}
+public:
+	// Values must not depend on the platform or the run
+	void testStable() {
+		IncrementalHash h;
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(0xba992926), h.get());
+		add(h, "hello");
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(0xfdb23244), h.get());
+		CPPUNIT_ASSERT(TokenId::is_hashed_content(h.get()));
+	}
+
+	void testReset() {
+		IncrementalHash h, h2;
+
+		add(h, "one");
+		h.reset();
+		add(h, "two");
+		add(h2, "two");
+		CPPUNIT_ASSERT_EQUAL(h2.get(), h.get());
+	}
+
+	// Tokens are distinct from the characters of their values
+	void testToken() {
+		IncrementalHash h, h2, h3;
+
+		add(h, "a");
+		h.add(static_cast<token_type>('('));
+		add(h2, "a(");
+		CPPUNIT_ASSERT(h.get() != h2.get());
+
+		h3.add(static_cast<token_type>(12));
+		h3.add(static_cast<token_type>(3));
+		h2.reset();
+		h2.add(static_cast<token_type>(1));
+		h2.add(static_cast<token_type>(23));
+		CPPUNIT_ASSERT(h2.get() != h3.get());
+	}
+
+	void testLong() {
+		IncrementalHash h, h2;
+
+		for (int i = 0; i < 1000000; i++)
+			h.add('x');
+		for (int i = 0; i < 999999; i++)
+			h2.add('x');
+		CPPUNIT_ASSERT(h.get() != h2.get());
+		h2.add('x');
+		CPPUNIT_ASSERT_EQUAL(h.get(), h2.get());
+	}
+};
+#endif /* INCREMENTALHASHTEST_H */
@@ -25,6 +25,7 @@
 #include "Token.h"
 
 // Process a JavaScript string literal starting with c, returning false on EOF
+template <bool AllContents>
 bool
 JavaScriptTokenizer::process_string_literal(char c)
 {
@@ -33,7 +34,7 @@ JavaScriptTokenizer::process_string_literal(char c)
 	bool is_template = (c == '`');
 
 	bol.saw_non_space();
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	for (;;) {
 		if (!src.get(c0)) {
@@ -43,7 +44,7 @@ JavaScriptTokenizer::process_string_literal(char c)
 		if (c0 == '\\') {
 			// Consume one character after the backslash
 			src.get(c0);
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 		} else if (is_template && c0 == '$') {
 			saw_dollar = true;
@@ -52,7 +53,7 @@ JavaScriptTokenizer::process_string_literal(char c)
 			int brace_depth = 1;
 			do {
 				token_type c = get_token();
-				if (all_contents)
+				if constexpr (AllContents)
 					sequence_hash.add(c);
 				if (c == '{')
 					++brace_depth;
@@ -70,22 +71,23 @@ JavaScriptTokenizer::process_string_literal(char c)
 			saw_dollar = false;
 		}
 
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c0);
 	}
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 	return true;
 }
 
 // Process a JavaScript regular expression literal, returning false on EOF
+template <bool AllContents>
 bool
 JavaScriptTokenizer::process_regex_literal()
 {
 	char c0;
 
 	bol.saw_non_space();
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	for (;;) {
 		if (!src.get(c0)) {
@@ -95,7 +97,7 @@ JavaScriptTokenizer::process_regex_literal()
 		if (c0 == '\\') {
 			// Consume one character after the backslash
 			src.get(c0);
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 		} else if (c0 == '/') {
 			// Termination; read flags
@@ -103,16 +105,16 @@ JavaScriptTokenizer::process_regex_literal()
 				src.get(c0);
 				if (!isalnum(c0))
 					break;
-				if (all_contents)
+				if constexpr (AllContents)
 					sequence_hash.add(c0);
 			}
 			src.push(c0);
 			break;
 		}
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c0);
 	}
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 	return true;
 }
@@ -122,10 +124,11 @@ JavaScriptTokenizer::process_regex_literal()
  * Return a token, maintaining the current context
  * (within an expression or not)
  */
+template <bool AllContents>
 inline token_type
-JavaScriptTokenizer::get_immediate_token()
+JavaScriptTokenizer::lex_token()
 {
-	token_type t = get_token_for_context();
+	token_type t = get_token_for_context<AllContents>();
 
 	// Some elements don't modify the state
 	if (TokenId::is_horizontal_space(t)
@@ -152,17 +155,18 @@ JavaScriptTokenizer::get_immediate_token()
  * In an expression context "/" is a division or /= operator.
  * Otherwise, it begins a regex literal scan.
  */
+template <bool AllContents>
 inline token_type
 JavaScriptTokenizer::get_token_for_context()
 {
-	char c0, c1, c2;
+	char c0, c1;
 	Keyword::IdentifierType key;
 
 	for (;;) {
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -190,280 +194,34 @@ JavaScriptTokenizer::get_token_for_context()
 		case ';':
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
-		/*
-		 * Double character C tokens with more than 2 different outcomes
-		 * (e.g. +, +=, ++)
-		 */
-		case '+':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '+':
-				return Token::PLUS_PLUS; // ++
-			case '=':
-				return Token::PLUS_EQUAL; // +=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '-':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '-':
-				return Token::MINUS_MINUS; // --
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Simple single/double character tokens (e.g. !, !=) */
-		case '%':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '^':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		// Tripple character operators
-		case '*':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* *= */
-				return Token::TIMES_EQUAL;
-			case '*':
-				src.get(c1);
-				switch (c1) {
-				case '=':	/* **= */
-					return Token::RAISE_EQUAL; // **=
-				default:
-					src.push(c1);
-					return Token::RAISE; // **
-				}
-				break;
-			default:				/* * */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '=':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '>':
-				return Token::LAMBDA; // =>
-			case '=':
-				src.get(c1);
-				switch (c1) {
-				case '=':	/* === */
-					return Token::EQUAL_STRICT; // ===
-				default:
-					src.push(c1);
-					return Token::EQUAL; // ==
-				}
-				break;
-			default:				/* = */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '!':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				src.get(c1);
-				switch (c1) {
-				case '=':	/* !== */
-					return Token::NOT_EQUAL_STRICT; // !===
-				default:
-					src.push(c1);
-					return Token::NOT_EQUAL; // !=
-				}
-				break;
-			default:				/* ! */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '&':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '&': /* && */
-				src.get(c1);
-				switch (c1) {
-				case '=':
-					return Token::BOOLEAN_AND_EQUAL; // &&=
-				default:
-					src.push(c1);
-					return Token::BOOLEAN_AND; // &&
-				}
-				break;
-			case '=':
-				return Token::AND_EQUAL; // &=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '|':
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case '<': case '=': case '>': case '?': case '^': case '|':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '|': /* || */
-				src.get(c1);
-				switch (c1) {
-				case '=':
-					return Token::BOOLEAN_OR_EQUAL; // ||=
-				default:
-					src.push(c1);
-					return Token::BOOLEAN_OR; // ||
-				}
-				break;
-			case '=':
-				return Token::OR_EQUAL; // |=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '?':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '?':
-				src.get(c1);
-				switch (c1) {
-				case '=':
-					// Avoid trigraph in string representation
-					return Token::NULL_COALESCING_EQUAL; // ??" "=
-				default:
-					src.push(c1);
-					return Token::NULL_COALESCING; // ??
-				}
-				break;
-			case '.':
-				return Token::NULL_CONDITIONAL; // ?.
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Operators starting with < or > */
-		case '>':
+			return get_operator_token(c0, Operator::JavaScript);
+		/* Comments and / operators */
+		case '/':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* >= */
-				return Token::GREATER_EQUAL; // >=
-			case '>':
+			switch (src.peek()) {
+			case '*':		/* Block comment */
 				src.get(c1);
-				switch (c1) {
-				case '=':	/* >>= */
-					return Token::RSHIFT_ARITHMETIC_EQUAL; // >>=
-				case '>':	/* >>> */
-					src.get(c2);
-					if (c2 == '=')
-						return Token::RSHIFT_LOGICAL_EQUAL; // >>>=
-					else {
-						src.push(c2);
-						return Token::RSHIFT_LOGICAL; // >>>
-					}
-				default:
-					src.push(c1);
-					return Token::RSHIFT_ARITHMETIC; // >>
-				}
-				break;
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '<':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* <= */
-				return Token::LESS_EQUAL; // <=
-			case '<':
+				return get_block_comment_token<AllContents>();
+			case '/':		/* Line comment */
 				src.get(c1);
-				if (c1 == '=')			/* <<= */
-					return Token::LSHIFT_EQUAL; // <<=
-				else {			/* << */
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-				break;
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+				return get_line_comment_token<AllContents>();
 			}
-			break;
-		/* Comments and / operators */
-		case '/':
-			bol.saw_non_space();
-			src.get(c1);
-			if (expression_context)
-				switch (c1) {
-				case '=':				/* /= */
-					return Token::DIV_EQUAL; // /=
-				case '*':		/* Block comment */
-					return get_block_comment_token();
-				case '/':		/* Line comment */
-					return get_line_comment_token();
-				default:		/* / */
-					src.push(c1);
-					return static_cast<token_type>(c0);
-				}
-			else // Non-expression context
-				switch (c1) {
-				case '*':		/* Block comment */
-					return get_block_comment_token();
-				case '/':		/* Line comment */
-					return get_line_comment_token();
-				default:		/* / */
-					src.push(c1);
-					if (process_regex_literal())
-						return Token::REGEX_LITERAL; // /.../
-					else
-						return 0;
-				}
+			if (expression_context)	/* / /= */
+				return get_operator_token(c0, Operator::JavaScript);
+			// Non-expression context
+			if (process_regex_literal<AllContents>())
+				return Token::REGEX_LITERAL; // /.../
+			else
+				return 0;
 		case '.':	/* . and ... */
 			bol.saw_non_space();
-			src.get(c1);
-			if (isdigit(c1)) {
-				val = std::string(".") + (char)(c1);
-				return get_number_token(val);
-			}
-			if (c1 != '.') {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			src.get(c2);
-			if (c2 != '.') {
-				src.push(c2);
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			return Token::ELIPSIS; // ...
+			if (isdigit(src.peek()))
+				return get_number_token(c0);
+			return get_operator_token(c0, Operator::JavaScript);
 		/* XXX Can also be non-ASCII */
 		case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
 		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k':
@@ -475,18 +233,11 @@ JavaScriptTokenizer::get_token_for_context()
 		case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
 		case 'V': case 'W': case 'X': case 'Y': case 'Z': case '$':
 			bol.saw_non_space();
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				if (!isalnum(c0) && c0 != '_' && c0 != '$')
-					break;
-				val += c0;
-			}
-			src.push(c0);
-			key = keyword.identifier_type(val);
+			get_word_value(c0, identifier_chars);
+			key = keyword.identifier_type(value);
 			switch (key) {
 			case Keyword::FIRST_IDENTIFIER:
-				return symbols.value(val);
+				return symbols.value(value);
 			case Keyword::K_class:
 			case Keyword::K_interface:
 			case Keyword::K_enum:
@@ -499,7 +250,7 @@ JavaScriptTokenizer::get_token_for_context()
 		case '`':
 		case '\'':
 		case '"':
-			if (process_string_literal(c0))
+			if (process_string_literal<AllContents>(c0))
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
@@ -507,8 +258,7 @@ JavaScriptTokenizer::get_token_for_context()
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
 			bol.saw_non_space();
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
@@ -519,3 +269,7 @@ JavaScriptTokenizer::get_token_for_context()
 JavaScriptTokenizer::~JavaScriptTokenizer()
 {
 }
+
+template token_type JavaScriptTokenizer::lex_token<false>();
+template token_type JavaScriptTokenizer::lex_token<true>();
+template class TokenizerImpl<JavaScriptTokenizer>;
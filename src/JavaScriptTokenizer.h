@@ -24,19 +24,22 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class JavaScriptTokenizer : public TokenizerBase {
+class JavaScriptTokenizer : public TokenizerImpl<JavaScriptTokenizer> {
 private:
 	Token javascript_token;
 	bool expression_context;  // When true / and /= are division operators
-	bool process_string_literal(char c);
-	bool process_regex_literal();
+	// Identifiers can also contain dollar signs
+	static constexpr ByteScan::WordChars identifier_chars{'_', '$'};
+	template <bool AllContents> bool process_string_literal(char c);
+	template <bool AllContents> bool process_regex_literal();
 	// Get a token, knowing the current context
-	inline token_type get_token_for_context();
+	template <bool AllContents> inline token_type get_token_for_context();
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -54,14 +57,14 @@ public:
 	JavaScriptTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {},
 			Keyword::LanguageId kw_id = Keyword::L_JavaScript) :
-		TokenizerBase(kw_id, s, file_name, opt),
+		TokenizerImpl(kw_id, s, file_name, opt),
 		expression_context(false) {}
 
 	// Construct for a string source
 	JavaScriptTokenizer(const std::string &s,
 			std::vector<std::string> opt = {},
 			Keyword::LanguageId kw_id = Keyword::L_JavaScript) :
-		TokenizerBase(kw_id, s, opt),
+		TokenizerImpl(kw_id, s, opt),
 		expression_context(false) {}
 
 	~JavaScriptTokenizer();
@@ -69,4 +72,5 @@ public:
 	friend class JavaScriptTokenizerTest;
 	friend class TypeScriptTokenizerTest;
 };
+extern template class TokenizerImpl<JavaScriptTokenizer>;
 #endif /* JAVASCRIPTTOKENIZER_H */
@@ -24,14 +24,15 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class JavaTokenizer : public TokenizerBase {
+class JavaTokenizer : public TokenizerImpl<JavaTokenizer> {
 private:
 	Token java_token;
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -48,14 +49,15 @@ public:
 	// Construct from a character source
 	JavaTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Java, s, file_name, opt) {}
+		TokenizerImpl(Keyword::L_Java, s, file_name, opt) {}
 
 	// Construct for a string source
 	JavaTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Java, s, opt) {}
+		TokenizerImpl(Keyword::L_Java, s, opt) {}
 
 	~JavaTokenizer();
 
 	friend class JavaTokenizerTest;
 };
+extern template class TokenizerImpl<JavaTokenizer>;
 #endif /* JAVATOKENIZER_H */
@@ -0,0 +1,103 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef KEYWORDBENCH_H
+#define KEYWORDBENCH_H
+
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Keyword.h"
+
+class KeywordBench {
+	// Return the identifiers and keywords appearing in the specified code
+	static std::vector<std::string> identifiers(const std::string &code) {
+		std::vector<std::string> ids;
+
+		for (size_t i = 0; i < code.size(); ) {
+			if (isalpha(code[i]) || code[i] == '_') {
+				size_t start = i;
+				while (i < code.size() &&
+				    (isalnum(code[i]) || code[i] == '_'))
+					i++;
+				ids.push_back(code.substr(start, i - start));
+			} else if (isdigit(code[i])) {
+				while (i < code.size() && isalnum(code[i]))
+					i++;
+			} else
+				i++;
+		}
+		return ids;
+	}
+
+	/*
+	 * Return the tokenizer's own C++ source code, as a stream of
+	 * real identifiers, or synthetic code if it isn't available.
+	 */
+	static std::string code() {
+		std::string s;
+
+		for (auto name : {"TokenizerBase.cpp", "CppTokenizer.cpp",
+				"JavaScriptTokenizer.cpp", "tokenizer.cpp"}) {
+			std::ifstream in(name);
+			std::ostringstream contents;
+			contents << in.rdbuf();
+			s += contents.str();
+		}
+		return s.empty() ? Benchmark::source_code(1024 * 1024) : s;
+	}
+public:
+	static void run() {
+		Keyword keyword(Keyword::L_Cpp);
+
+		// The std::map lookup previously used
+		std::map<std::string, Keyword::IdentifierType> km;
+		for (auto k : keyword.token_keyword_view())
+			if (keyword.identifier_type(k.second) != Keyword::FIRST_IDENTIFIER)
+				km.emplace(k.second,
+					keyword.identifier_type(k.second));
+
+		std::vector<std::string> ids(identifiers(code()));
+		while (ids.size() < 4 * 1024 * 1024)
+			ids.insert(ids.end(), ids.begin(), ids.end());
+
+		double before = Benchmark::run("Keyword std::map lookup",
+			ids.size(), "identifier", [&km, &ids]() {
+				size_t n = 0;
+				for (auto &id : ids) {
+					auto f = km.find(id);
+					n += f == km.end() ?
+						Keyword::FIRST_IDENTIFIER :
+						f->second;
+				}
+				return n;
+			});
+		double after = Benchmark::run("Keyword perfect hash lookup",
+			ids.size(), "identifier", [&keyword, &ids]() {
+				size_t n = 0;
+				for (auto &id : ids)
+					n += keyword.identifier_type(id);
+				return n;
+			});
+		Benchmark::speedup(before, after);
+	}
+};
+#endif /* KEYWORDBENCH_H */
@@ -0,0 +1,291 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LshIndex.h"
+
+static const char MAGIC[8] = {'T', 'O', 'K', 'L', 'S', 'H', '1', '\n'};
+
+// Size of the buffer for writing the index
+static const size_t WRITE_BUFFER = 64 * 1024;
+
+// Return n rounded up to a multiple of 8
+static uint64_t
+align8(uint64_t n)
+{
+	return (n + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Write the specified data to fd; return false on error
+static bool
+write_all(int fd, const char *data, size_t size)
+{
+	while (size) {
+		ssize_t r = write(fd, data, size);
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r == -1)
+			return false;
+		data += r;
+		size -= r;
+	}
+	return true;
+}
+
+// Return the hash of band b, which holds the specified values
+static uint64_t
+band_hash(unsigned b, const uint32_t *values, unsigned rows)
+{
+	uint64_t h = 0xcbf29ce484222325ULL + b;
+
+	for (unsigned i = 0; i < rows; i++) {
+		h = (h ^ values[i]) * 0x9e3779b97f4a7c15ULL;
+		h ^= h >> 32;
+	}
+	return h;
+}
+
+void
+LshIndex::Builder::add_file(const std::string &name, const MinHash &m)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t file = names.size();
+	names.push_back(name);
+	for (size_t i = 0; i < m.size(); i++) {
+		units.push_back({file, m.get_unit(i)});
+		signatures.insert(signatures.end(), m.signature(i),
+			m.signature(i) + nhashes);
+	}
+}
+
+/*
+ * The file consists of the header, the NUL-terminated file names,
+ * the units, their signatures, and their bands,
+ * each section padded to a multiple of eight bytes.
+ */
+bool
+LshIndex::Builder::write(const std::string &path)
+{
+	int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1)
+		return false;
+
+	std::vector<size_t> order(units.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+		const FileUnit &ua = units[a], &ub = units[b];
+		return std::tie(names[ua.file], ua.unit.begin, a) <
+			std::tie(names[ub.file], ub.unit.begin, b);
+	});
+
+	// Store the names in the order of the units, which contain them
+	std::string name_data;
+	std::vector<uint64_t> name_offset(names.size(), UINT64_MAX);
+	for (size_t i : order) {
+		size_t f = units[i].file;
+		if (name_offset[f] != UINT64_MAX)
+			continue;
+		name_offset[f] = name_data.size();
+		name_data.append(names[f].c_str(), names[f].size() + 1);
+	}
+	name_data.resize(align8(name_data.size()));
+
+	unsigned nbands = nhashes / rows;
+	Header h;
+	memcpy(h.magic, MAGIC, sizeof(MAGIC));
+	h.nhashes = nhashes;
+	h.width = width;
+	h.rows = rows;
+	h.nbands = nbands;
+	h.nunits = units.size();
+	h.names_size = name_data.size();
+
+	std::vector<Band> bands;
+	bands.reserve(units.size() * nbands);
+	for (size_t i = 0; i < order.size(); i++) {
+		const uint32_t *s = signatures.data() + order[i] * nhashes;
+		for (unsigned b = 0; b < nbands; b++)
+			bands.push_back({band_hash(b, s + b * rows, rows), i});
+	}
+	std::sort(bands.begin(), bands.end(), [](const Band &a, const Band &b) {
+		return std::tie(a.hash, a.unit) < std::tie(b.hash, b.unit);
+	});
+
+	// Write errors are returned, rather than terminating the process
+	std::string buffer;
+	bool ok = true;
+	auto put = [&](const void *data, size_t size) {
+		buffer.append(static_cast<const char *>(data), size);
+		if (buffer.size() >= WRITE_BUFFER) {
+			ok = ok && write_all(fd, buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	};
+	put(&h, sizeof(h));
+	put(name_data.data(), name_data.size());
+	for (size_t i : order) {
+		const FileUnit &u = units[i];
+		Unit record{u.unit.begin, u.unit.end, name_offset[u.file]};
+		put(&record, sizeof(record));
+	}
+	for (size_t i : order)
+		put(signatures.data() + i * nhashes, nhashes * sizeof(uint32_t));
+	if (units.size() * nhashes % 2) {
+		uint32_t padding = 0;
+		put(&padding, sizeof(padding));
+	}
+	ok = ok && write_all(fd, buffer.data(), buffer.size()) &&
+		write_all(fd, reinterpret_cast<const char *>(bands.data()),
+		bands.size() * sizeof(Band));
+
+	int e = errno;
+	if (close(fd) == -1 && ok) {
+		ok = false;
+		e = errno;
+	}
+	if (!ok) {
+		unlink(path.c_str());
+		errno = e;
+	}
+	return ok;
+}
+
+LshIndex::~LshIndex()
+{
+	if (map)
+		munmap(const_cast<char *>(map), map_size);
+}
+
+std::unique_ptr<LshIndex>
+LshIndex::open(const std::string &path)
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat sb;
+	if (fstat(fd, &sb) == -1) {
+		int e = errno;
+		close(fd);
+		errno = e;
+		return nullptr;
+	}
+	if (static_cast<uint64_t>(sb.st_size) < sizeof(Header)) {
+		close(fd);
+		errno = EINVAL;
+		return nullptr;
+	}
+
+	void *p = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	int e = errno;
+	close(fd);
+	if (p == MAP_FAILED) {
+		errno = e;
+		return nullptr;
+	}
+
+	std::unique_ptr<LshIndex> index(new LshIndex());
+	index->map = static_cast<const char *>(p);
+	index->map_size = sb.st_size;
+	const Header *h = index->header =
+		reinterpret_cast<const Header *>(index->map);
+
+	// Verify that the sections fit the file exactly
+	uint64_t size = sb.st_size;
+	if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+	    h->nhashes == 0 || h->nhashes > MinHash::MAX_HASHES ||
+	    h->rows == 0 || h->rows > h->nhashes ||
+	    h->nbands != h->nhashes / h->rows ||
+	    h->width == 0 || h->width > MinHash::MAX_WIDTH ||
+	    h->names_size % 8 != 0 || h->names_size > size ||
+	    h->nunits > size / sizeof(Unit)) {
+		errno = EINVAL;
+		return nullptr;
+	}
+	uint64_t names_end = sizeof(Header) + h->names_size;
+	uint64_t units_end = names_end + h->nunits * sizeof(Unit);
+	uint64_t signatures_end = units_end +
+		align8(h->nunits * h->nhashes * sizeof(uint32_t));
+	if (signatures_end + h->nunits * h->nbands * sizeof(Band) != size) {
+		errno = EINVAL;
+		return nullptr;
+	}
+
+	index->names = index->map + sizeof(Header);
+	index->units = reinterpret_cast<const Unit *>(index->map + names_end);
+	index->signatures = reinterpret_cast<const uint32_t *>(index->map +
+		units_end);
+	index->bands = reinterpret_cast<const Band *>(index->map +
+		signatures_end);
+	// Names must end within their section
+	if (h->names_size && index->names[h->names_size - 1] != '\0') {
+		errno = EINVAL;
+		return nullptr;
+	}
+	for (uint64_t i = 0; i < h->nunits; i++)
+		if (index->units[i].name >= h->names_size) {
+			errno = EINVAL;
+			return nullptr;
+		}
+	return index;
+}
+
+void
+LshIndex::query(const uint32_t *signature,
+	const std::function<void(const Match &)> &found) const
+{
+	unsigned nhashes = header->nhashes, rows = header->rows;
+	const Band *end = bands + header->nunits * header->nbands;
+
+	std::vector<uint64_t> candidates;
+	for (unsigned b = 0; b < header->nbands; b++) {
+		uint64_t h = band_hash(b, signature + b * rows, rows);
+		const Band *p = std::lower_bound(bands, end, h,
+			[](const Band &a, uint64_t v) { return a.hash < v; });
+		for (; p < end && p->hash == h; p++)
+			candidates.push_back(p->unit);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()),
+		candidates.end());
+
+	std::vector<Match> matches;
+	for (uint64_t c : candidates) {
+		const uint32_t *s = signatures + c * nhashes;
+		unsigned nequal = 0;
+		for (unsigned i = 0; i < nhashes; i++)
+			nequal += (s[i] == signature[i]);
+		const Unit &u = units[c];
+		matches.push_back({names + u.name, u.begin, u.end, nequal});
+	}
+	// Sorting is stable, so units stay in their index order
+	std::stable_sort(matches.begin(), matches.end(),
+		[](const Match &a, const Match &b) {
+			return a.nequal > b.nequal;
+		});
+	for (const Match &m : matches)
+		found(m);
+}
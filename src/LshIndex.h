@@ -0,0 +1,139 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef LSHINDEX_H
+#define LSHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MinHash.h"
+
+/**
+ * A locality-sensitive hashing index of units' MinHash signatures,
+ * stored in a file.
+ * Each signature is cut into bands of a fixed number of values,
+ * and the index holds the hash of each band sorted together with its
+ * unit, so that the units sharing a band with a signature can be found
+ * with binary searches in the mapped file.
+ * Units whose shingles are similar are likely to share at least one band.
+ */
+class LshIndex {
+public:
+	// The file's header, in native byte order
+	struct Header {
+		char magic[8];
+		uint32_t nhashes;	// Values in each signature
+		uint32_t width;		// Tokens in each shingle
+		uint32_t rows;		// Values in each band
+		uint32_t nbands;	// Bands in each signature
+		uint64_t nunits;	// Units indexed
+		uint64_t names_size;	// Bytes of file names, padded
+	};
+
+	// A unit of the index
+	struct Unit {
+		uint64_t begin;		// Its first line
+		uint64_t end;		// Its last line
+		uint64_t name;		// Offset of its file's name
+	};
+
+	// A band of a unit
+	struct Band {
+		uint64_t hash;		// Hash of the band and its values
+		uint64_t unit;		// The unit's position
+	};
+
+	// An indexed unit found by a query
+	struct Match {
+		const char *file;	// Name of its file
+		uint64_t begin;		// Its first line
+		uint64_t end;		// Its last line
+		unsigned nequal;	// Signature values equal to the query's
+	};
+
+	// Accumulate the signatures of files and write them as an index
+	class Builder {
+		unsigned nhashes, width, rows;
+		std::vector<std::string> names;	// Name of each file
+		// A unit and the file containing it
+		struct FileUnit {
+			size_t file;
+			MinHash::Unit unit;
+		};
+		std::vector<FileUnit> units;	// Units of all files
+		std::vector<uint32_t> signatures;	// Their signatures
+		std::mutex mutex;	// Protects the above when adding files
+	public:
+		// Index signatures with the specified parameters
+		Builder(unsigned n, unsigned w, unsigned r) :
+			nhashes(n), width(w), rows(r) {}
+
+		/**
+		 * Add the signatures of the named file's units.
+		 * Files can be added concurrently.
+		 */
+		void add_file(const std::string &name, const MinHash &m);
+
+		/**
+		 * Write the index to the specified file, with the units
+		 * ordered by their file's name and their lines.
+		 * Return false, with errno set, if it can't be created
+		 * or written; a partially written file is removed.
+		 */
+		bool write(const std::string &path);
+	};
+private:
+	const char *map;		// The mapped file
+	size_t map_size;		// Its size
+	const Header *header;
+	const char *names;		// The files' names
+	const Unit *units;		// The units
+	const uint32_t *signatures;	// Their signatures
+	const Band *bands;		// All bands, ordered by hash and unit
+
+	LshIndex() : map(nullptr), map_size(0) {}
+public:
+	~LshIndex();
+	LshIndex(const LshIndex &) = delete;
+	LshIndex &operator=(const LshIndex &) = delete;
+
+	/**
+	 * Return the index stored in the specified file.
+	 * Return nullptr, with errno set, if the file can't be opened
+	 * or isn't a valid index.
+	 */
+	static std::unique_ptr<LshIndex> open(const std::string &path);
+
+	// Return the parameters of the indexed signatures
+	unsigned get_nhashes() const { return header->nhashes; }
+	unsigned get_width() const { return header->width; }
+	unsigned get_rows() const { return header->rows; }
+
+	/**
+	 * Call found with each indexed unit sharing a band with the
+	 * specified signature, in decreasing order of equal values,
+	 * and then in the order of the units in the index.
+	 */
+	void query(const uint32_t *signature,
+		const std::function<void(const Match &)> &found) const;
+};
+#endif /* LSHINDEX_H */
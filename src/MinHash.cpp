@@ -0,0 +1,76 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "MinHash.h"
+
+// Return the next value of the SplitMix64 generator with the state s
+static uint64_t
+splitmix64(uint64_t &s)
+{
+	uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/*
+ * The hash functions map a shingle's 64-bit hash h to the high 32 bits
+ * of a * h + b, with a odd; a 2-universal family.
+ */
+MinHash::MinHash(unsigned n, unsigned w) : nhashes(n), width(w),
+	pos(0), ntokens(0), minimum(n, UINT32_MAX), unit{0, 0}
+{
+	assert(nhashes >= 1 && nhashes <= MAX_HASHES);
+	assert(width >= 1 && width <= MAX_WIDTH);
+	uint64_t state = 0;
+	for (unsigned i = 0; i < nhashes; i++) {
+		multipliers.push_back(splitmix64(state) | 1);
+		addends.push_back(splitmix64(state));
+	}
+}
+
+void
+MinHash::add_shingle(const token_type *s, unsigned n)
+{
+	uint64_t h = n;
+	for (unsigned i = 0; i < n; i++) {
+		h = (h ^ s[i]) * 0x9e3779b97f4a7c15ULL;
+		h ^= h >> 29;
+	}
+
+	for (unsigned i = 0; i < nhashes; i++) {
+		uint32_t v = (multipliers[i] * h + addends[i]) >> 32;
+		minimum[i] = std::min(minimum[i], v);
+	}
+}
+
+void
+MinHash::end_unit()
+{
+	if (ntokens == 0)
+		return;
+	if (ntokens < width)
+		add_shingle(window + pos + width - ntokens, ntokens);
+
+	units.push_back(unit);
+	signatures.insert(signatures.end(), minimum.begin(), minimum.end());
+	std::fill(minimum.begin(), minimum.end(), UINT32_MAX);
+	ntokens = 0;
+}
@@ -0,0 +1,101 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "TokenId.h"
+
+/**
+ * Compute the MinHash signature of each unit of the tokens added to it.
+ * The signature consists of the minimum value, over the unit's shingles
+ * (its runs of a fixed number of consecutive tokens), of each of
+ * several hash functions.
+ * The fraction of equal values in the signatures of two units
+ * estimates the Jaccard similarity of their sets of shingles.
+ * Units shorter than a shingle form a single shorter shingle;
+ * units without tokens are ignored.
+ */
+class MinHash {
+public:
+	static const unsigned MAX_WIDTH = 16;	// Longest shingle
+	static const unsigned MAX_HASHES = 1024;	// Longest signature
+
+	// The lines a unit spans
+	struct Unit {
+		uint64_t begin;		// Line of its first token
+		uint64_t end;		// Line of its last token
+	};
+private:
+	unsigned nhashes;		// Number of values in a signature
+	unsigned width;			// Number of tokens in a shingle
+	// Multiplier and addend of each hash function
+	std::vector<uint64_t> multipliers, addends;
+	// The last tokens, stored twice, as in NgramCounter
+	token_type window[2 * MAX_WIDTH];
+	unsigned pos;			// Position of the oldest token
+	uint64_t ntokens;		// Tokens in the current unit
+	std::vector<uint32_t> minimum;	// Current unit's signature
+	Unit unit;			// Current unit's lines
+	std::vector<Unit> units;	// Completed units
+	std::vector<uint32_t> signatures;	// Their signatures
+
+	// Update the minimum values with the n tokens of the shingle s
+	void add_shingle(const token_type *s, unsigned n);
+public:
+	/**
+	 * Create signatures with the specified number of values,
+	 * between 1 and MAX_HASHES, over shingles with the specified
+	 * number of tokens, between 1 and MAX_WIDTH.
+	 * The hash functions only depend on the number of values,
+	 * so signatures created with the same parameters are comparable.
+	 */
+	MinHash(unsigned nhashes, unsigned width);
+
+	// Add a token that ends in the specified line
+	void add(token_type t, uint64_t line) {
+		if (ntokens == 0)
+			unit.begin = line;
+		unit.end = line;
+		window[pos] = window[pos + width] = t;
+		if (++pos == width)
+			pos = 0;
+		if (++ntokens >= width)
+			add_shingle(window + pos, width);
+	}
+
+	// End the current unit, storing its signature if it isn't empty
+	void end_unit();
+
+	// Return the number of units with a signature
+	size_t size() const { return units.size(); }
+
+	// Return the lines of the specified unit
+	const Unit &get_unit(size_t i) const { return units[i]; }
+
+	// Return the signature of the specified unit
+	const uint32_t *signature(size_t i) const {
+		return signatures.data() + i * nhashes;
+	}
+
+	// Return the number of values in each signature
+	unsigned get_nhashes() const { return nhashes; }
+};
+#endif /* MINHASH_H */
@@ -0,0 +1,228 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef MINHASHTEST_H
+#define MINHASHTEST_H
+
+#include <cerrno>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CTokenizer.h"
+#include "LshIndex.h"
+#include "MinHash.h"
+
+class MinHashTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(MinHashTest);
+	CPPUNIT_TEST(testIdentical);
+	CPPUNIT_TEST(testSimilarity);
+	CPPUNIT_TEST(testShortUnits);
+	CPPUNIT_TEST(testIndex);
+	CPPUNIT_TEST(testInvalidIndex);
+	CPPUNIT_TEST(testIndexWriteError);
+	CPPUNIT_TEST(testTokenize);
+	CPPUNIT_TEST_SUITE_END();
+
+	std::string dir;		// Directory holding the indexes
+
+	// Add a unit containing the specified tokens on line 1 to m
+	static void add(MinHash &m, const std::vector<token_type> &tokens) {
+		for (auto t : tokens)
+			m.add(t, 1);
+		m.end_unit();
+	}
+
+	// Return the number of equal values in the signatures of units a, b
+	static unsigned nequal(const MinHash &m, size_t a, size_t b) {
+		unsigned n = 0;
+		for (unsigned i = 0; i < m.get_nhashes(); i++)
+			n += (m.signature(a)[i] == m.signature(b)[i]);
+		return n;
+	}
+
+	// Return the matches of the specified unit of m in index as text
+	static std::string query(const LshIndex &index, const MinHash &m,
+			size_t unit) {
+		std::ostringstream s;
+
+		index.query(m.signature(unit), [&s](const LshIndex::Match &r) {
+			s << r.file << ':' << r.begin << '-' << r.end << ' ' <<
+				r.nequal << '\n';
+		});
+		return s.str();
+	}
+public:
+	void setUp() {
+		char name[] = "/tmp/MinHashTestXXXXXX";
+		CPPUNIT_ASSERT(mkdtemp(name));
+		dir = name;
+	}
+
+	void tearDown() {
+		std::filesystem::remove_all(dir);
+	}
+
+	void testIdentical() {
+		MinHash m1(64, 3), m2(64, 3);
+
+		add(m1, {1, 2, 3, 4, 5, 6});
+		add(m2, {9, 9});
+		add(m2, {1, 2, 3, 4, 5, 6});
+		CPPUNIT_ASSERT_EQUAL(size_t(1), m1.size());
+		CPPUNIT_ASSERT_EQUAL(size_t(2), m2.size());
+		for (unsigned i = 0; i < 64; i++)
+			CPPUNIT_ASSERT_EQUAL(m1.signature(0)[i],
+				m2.signature(1)[i]);
+		CPPUNIT_ASSERT(nequal(m2, 0, 1) < 8);
+	}
+
+	// Equal values estimate the Jaccard similarity of the shingles
+	void testSimilarity() {
+		MinHash m(512, 1);
+		std::vector<token_type> a, b;
+
+		// 100 shared tokens and 100 distinct ones in each unit
+		for (token_type t = 0; t < 200; t++) {
+			a.push_back(t);
+			b.push_back(t + 100);
+		}
+		add(m, a);
+		add(m, b);
+		unsigned n = nequal(m, 0, 1);
+		// The similarity is 1/3
+		CPPUNIT_ASSERT(n > 512 / 3 - 40 && n < 512 / 3 + 40);
+	}
+
+	// Short units form a single shingle; empty ones are ignored
+	void testShortUnits() {
+		MinHash m(16, 4);
+
+		m.end_unit();
+		m.add(7, 3);
+		m.add(8, 5);
+		m.end_unit();
+		add(m, {7, 8});
+		add(m, {8, 7});
+		CPPUNIT_ASSERT_EQUAL(size_t(3), m.size());
+		CPPUNIT_ASSERT_EQUAL(uint64_t(3), m.get_unit(0).begin);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(5), m.get_unit(0).end);
+		CPPUNIT_ASSERT_EQUAL(16u, nequal(m, 0, 1));
+		CPPUNIT_ASSERT(nequal(m, 0, 2) < 16);
+	}
+
+	void testIndex() {
+		MinHash m1(32, 2), m2(32, 2);
+		std::vector<token_type> base;
+
+		for (token_type t = 0; t < 100; t++)
+			base.push_back(t);
+		add(m1, base);
+		base[50] = 1000;
+		add(m2, base);
+		add(m2, {500, 501, 502, 503, 504, 505});
+
+		LshIndex::Builder b(32, 2, 4);
+		b.add_file("b", m2);
+		b.add_file("a", m1);
+		std::string name(dir + "/index");
+		CPPUNIT_ASSERT(b.write(name));
+
+		auto index = LshIndex::open(name);
+		CPPUNIT_ASSERT(index);
+		CPPUNIT_ASSERT_EQUAL(32u, index->get_nhashes());
+		CPPUNIT_ASSERT_EQUAL(2u, index->get_width());
+		CPPUNIT_ASSERT_EQUAL(4u, index->get_rows());
+
+		// Matches are ordered by similarity and then by name
+		CPPUNIT_ASSERT_EQUAL(std::string("a:1-1 32\nb:1-1 31\n"),
+			query(*index, m1, 0));
+		CPPUNIT_ASSERT_EQUAL(std::string("b:1-1 32\n"),
+			query(*index, m2, 1));
+	}
+
+	void testInvalidIndex() {
+		std::string name(dir + "/index");
+
+		errno = 0;
+		CPPUNIT_ASSERT(!LshIndex::open(name));
+		CPPUNIT_ASSERT_EQUAL(ENOENT, errno);
+
+		std::ofstream(name) << "TOKLSH1\nnot really an index";
+		CPPUNIT_ASSERT(!LshIndex::open(name));
+		CPPUNIT_ASSERT_EQUAL(EINVAL, errno);
+
+		LshIndex::Builder b(8, 4, 2);
+		CPPUNIT_ASSERT(b.write(name));
+		CPPUNIT_ASSERT(LshIndex::open(name));
+		std::filesystem::resize_file(name,
+			std::filesystem::file_size(name) + 8);
+		CPPUNIT_ASSERT(!LshIndex::open(name));
+	}
+
+	// Write errors are returned, and the partial index is removed
+	void testIndexWriteError() {
+		MinHash m(64, 2);
+		for (token_type t = 0; t < 10000; t++)
+			add(m, {t, t + 1, t + 2});
+		LshIndex::Builder b(64, 2, 4);
+		b.add_file("a", m);
+		std::string name(dir + "/index");
+
+		// Limit the file's size, so that writing it fails with EFBIG
+		struct rlimit saved, limit;
+		CPPUNIT_ASSERT(getrlimit(RLIMIT_FSIZE, &saved) == 0);
+		limit = saved;
+		limit.rlim_cur = 4096;
+		auto handler = signal(SIGXFSZ, SIG_IGN);
+		CPPUNIT_ASSERT(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+		bool ok = b.write(name);
+		int e = errno;
+		setrlimit(RLIMIT_FSIZE, &saved);
+		signal(SIGXFSZ, handler);
+
+		CPPUNIT_ASSERT(!ok);
+		CPPUNIT_ASSERT_EQUAL(EFBIG, e);
+		CPPUNIT_ASSERT(!std::filesystem::exists(name));
+		CPPUNIT_ASSERT(b.write(name));
+		CPPUNIT_ASSERT(LshIndex::open(name));
+	}
+
+	// Units are those of the numeric output
+	void testTokenize() {
+		MinHash m1(16, 3), m2(16, 3);
+		CTokenizer t1("int a;\n\nint f()\n{\n\treturn a + 1;\n}\n",
+			{"method"});
+		CTokenizer t2("int g()\n{\n\treturn y + 2;\n}\n", {"method"});
+
+		t1.minhash_tokenize(m1, true);
+		t2.minhash_tokenize(m2, true);
+		CPPUNIT_ASSERT_EQUAL(size_t(1), m1.size());
+		CPPUNIT_ASSERT_EQUAL(uint64_t(4), m1.get_unit(0).begin);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(6), m1.get_unit(0).end);
+		for (unsigned i = 0; i < 16; i++)
+			CPPUNIT_ASSERT_EQUAL(m1.signature(0)[i],
+				m2.signature(0)[i]);
+	}
+};
+#endif /* MINHASHTEST_H */
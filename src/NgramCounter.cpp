@@ -0,0 +1,355 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <string>
+
+#include <unistd.h>
+
+#include "NgramCounter.h"
+
+// Initial number of hash table slots; a power of two
+static const size_t MIN_SLOTS = 1024;
+
+// Size of the buffer used for reading each run
+static const size_t RUN_BUFFER = 64 * 1024;
+
+// Return the hash of the n tokens of key
+static inline uint64_t
+hash(const token_type *key, unsigned n)
+{
+	uint64_t h = n;
+
+	for (unsigned i = 0; i < n; i++)
+		h = (h ^ key[i]) * 0x9e3779b97f4a7c15ULL;
+	return h ^ (h >> 29);
+}
+
+// Return true if the n tokens of a sort before those of b
+static inline bool
+less(const token_type *a, const token_type *b, unsigned n)
+{
+	for (unsigned i = 0; i < n; i++)
+		if (a[i] != b[i])
+			return a[i] < b[i];
+	return false;
+}
+
+NgramCounter::NgramCounter(unsigned n_, size_t m) : n(n_),
+	max_memory(m), pos(0), ntokens(0)
+{
+	assert(n >= 1 && n <= MAX_N);
+	slots.assign(MIN_SLOTS, 0);
+	keys.reserve(MIN_SLOTS / 2 * n);
+	counts.reserve(MIN_SLOTS / 2);
+}
+
+NgramCounter::~NgramCounter()
+{
+	for (int fd : runs)
+		close(fd);
+}
+
+/*
+ * The table is at most half full; spilling it also needs the
+ * order of its entries.
+ */
+size_t
+NgramCounter::table_memory(size_t nslots) const
+{
+	return nslots * sizeof(uint64_t) + nslots / 2 *
+		(n * sizeof(token_type) + sizeof(uint64_t) + sizeof(uint32_t));
+}
+
+void
+NgramCounter::count(const token_type *key)
+{
+	uint64_t h = hash(key, n);
+	uint64_t tag = h & 0xffffffff00000000ULL;
+	size_t mask = slots.size() - 1;
+	size_t i;
+
+	for (i = h & mask; slots[i]; i = (i + 1) & mask)
+		if ((slots[i] & 0xffffffff00000000ULL) == tag) {
+			uint32_t e = static_cast<uint32_t>(slots[i]) - 1;
+			if (std::equal(key, key + n, keys.data() + e * n)) {
+				counts[e]++;
+				return;
+			}
+		}
+
+	if ((counts.size() + 1) * 2 > slots.size()) {
+		if (!grow())
+			spill();
+		count(key);
+		return;
+	}
+	keys.insert(keys.end(), key, key + n);
+	counts.push_back(1);
+	slots[i] = tag | counts.size();
+}
+
+bool
+NgramCounter::grow()
+{
+	size_t nslots = slots.size() * 2;
+	// Entry numbers must also fit in the slots
+	if (table_memory(nslots) > max_memory || nslots / 2 >= UINT32_MAX)
+		return false;
+
+	slots.assign(nslots, 0);
+	keys.reserve(nslots / 2 * n);
+	counts.reserve(nslots / 2);
+	size_t mask = nslots - 1;
+	for (size_t e = 0; e < counts.size(); e++) {
+		uint64_t h = hash(keys.data() + e * n, n);
+		size_t i;
+		for (i = h & mask; slots[i]; i = (i + 1) & mask)
+			;
+		slots[i] = (h & 0xffffffff00000000ULL) | (e + 1);
+	}
+	return true;
+}
+
+std::vector<uint32_t>
+NgramCounter::sorted() const
+{
+	std::vector<uint32_t> order(counts.size());
+
+	for (uint32_t e = 0; e < order.size(); e++)
+		order[e] = e;
+	const token_type *k = keys.data();
+	unsigned len = n;
+	std::sort(order.begin(), order.end(),
+		[k, len](uint32_t a, uint32_t b) {
+			return less(k + a * len, k + b * len, len);
+		});
+	return order;
+}
+
+// Write the specified data to fd; return false on error
+static bool
+write_all(int fd, const char *data, size_t size)
+{
+	while (size) {
+		ssize_t r = write(fd, data, size);
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r == -1)
+			return false;
+		data += r;
+		size -= r;
+	}
+	return true;
+}
+
+/*
+ * Runs consist of fixed-size records holding each n-gram's tokens
+ * and its count in native form.
+ * Their files are unlinked when created, so they are removed
+ * when the counter closes them, or when the process terminates.
+ * Failures don't terminate the process, which may be serving other
+ * requests, but are reported when the counts are merged.
+ */
+void
+NgramCounter::spill()
+{
+	const char *tmpdir = getenv("TMPDIR");
+	const std::string pattern(std::string(tmpdir ? tmpdir : "/tmp") +
+		"/tokenizer.XXXXXX");
+	std::string name(pattern);
+	int fd = error.empty() ? mkstemp(&name[0]) : -1;
+	if (fd == -1 && error.empty())
+		error = "Unable to create temporary file " + pattern + ": " +
+			strerror(errno);
+	if (fd != -1) {
+		unlink(name.c_str());
+
+		std::string buffer;
+		bool ok = true;
+		for (uint32_t e : sorted()) {
+			buffer.append(reinterpret_cast<const char *>(
+				keys.data() + e * n), n * sizeof(token_type));
+			buffer.append(reinterpret_cast<const char *>(
+				&counts[e]), sizeof(uint64_t));
+			if (buffer.size() >= RUN_BUFFER) {
+				ok = ok && write_all(fd, buffer.data(),
+					buffer.size());
+				buffer.clear();
+			}
+		}
+		ok = ok && write_all(fd, buffer.data(), buffer.size());
+		if (ok && lseek(fd, 0, SEEK_SET) == 0)
+			runs.push_back(fd);
+		else {
+			error = std::string("Unable to write temporary file: ") +
+				strerror(errno);
+			close(fd);
+		}
+	}
+
+	std::fill(slots.begin(), slots.end(), 0);
+	keys.clear();
+	counts.clear();
+}
+
+// A sorted source of n-grams and their counts
+class NgramSource {
+public:
+	std::vector<token_type> key;	// Current n-gram
+	uint64_t count;			// Its count
+
+	NgramSource(unsigned n) : key(n), count(0) {}
+	virtual ~NgramSource() {}
+	// Advance to the next n-gram; return false at the end
+	virtual bool next() = 0;
+};
+
+// The n-grams of a counter's table, in the specified order
+class TableSource : public NgramSource {
+	const token_type *keys;
+	const uint64_t *counts;
+	std::vector<uint32_t> order;
+	size_t i;			// Next entry of order
+public:
+	TableSource(unsigned n, const token_type *k, const uint64_t *c,
+			std::vector<uint32_t> &&o) : NgramSource(n), keys(k),
+		counts(c), order(std::move(o)), i(0) {}
+
+	bool next() override {
+		if (i == order.size())
+			return false;
+		uint32_t e = order[i++];
+		std::copy(keys + e * key.size(), keys + (e + 1) * key.size(),
+			key.begin());
+		count = counts[e];
+		return true;
+	}
+};
+
+/*
+ * The n-grams of a run read from a file descriptor.
+ * Read errors end the run, after setting error to errno.
+ */
+class RunSource : public NgramSource {
+	int fd;
+	int &error;
+	std::vector<char> buffer;
+	size_t record_size;
+	size_t pos, end;		// Unread data in the buffer
+public:
+	RunSource(unsigned n, int f, int &e) : NgramSource(n), fd(f),
+		error(e),
+		record_size(n * sizeof(token_type) + sizeof(uint64_t)),
+		pos(0), end(0) {
+		buffer.resize(RUN_BUFFER / record_size * record_size);
+	}
+
+	bool next() override {
+		if (end - pos < record_size) {
+			// Keep a partially read record, and read more data
+			std::copy(buffer.begin() + pos, buffer.begin() + end,
+				buffer.begin());
+			end -= pos;
+			pos = 0;
+			while (end < buffer.size()) {
+				ssize_t r = read(fd, buffer.data() + end,
+					buffer.size() - end);
+				if (r == -1 && errno == EINTR)
+					continue;
+				if (r == -1) {
+					error = errno;
+					return false;
+				}
+				if (r == 0)
+					break;
+				end += r;
+			}
+			if (end < record_size)
+				return false;
+		}
+		size_t key_size = key.size() * sizeof(token_type);
+		memcpy(key.data(), buffer.data() + pos, key_size);
+		memcpy(&count, buffer.data() + pos + key_size, sizeof(count));
+		pos += record_size;
+		return true;
+	}
+};
+
+bool
+NgramCounter::merge(const std::vector<NgramCounter *> &counters,
+		const Writer &w, std::ostream &err)
+{
+	for (auto c : counters)
+		if (!c->error.empty()) {
+			err << c->error << std::endl;
+			return false;
+		}
+	if (counters.empty())
+		return true;
+	unsigned n = counters[0]->n;
+
+	int error = 0;
+	std::vector<std::unique_ptr<NgramSource>> sources;
+	for (auto c : counters) {
+		assert(c->n == n);
+		for (int fd : c->runs)
+			sources.emplace_back(new RunSource(n, fd, error));
+		sources.emplace_back(new TableSource(n, c->keys.data(),
+			c->counts.data(), c->sorted()));
+	}
+
+	// Sources ordered by their current n-gram, smallest on top
+	auto greater = [n](NgramSource *a, NgramSource *b) {
+		return less(b->key.data(), a->key.data(), n);
+	};
+	std::priority_queue<NgramSource *, std::vector<NgramSource *>,
+		decltype(greater)> queue(greater);
+	for (auto &s : sources)
+		if (s->next())
+			queue.push(s.get());
+
+	std::vector<token_type> key(n);
+	uint64_t count = 0;
+	while (!queue.empty()) {
+		NgramSource *s = queue.top();
+		queue.pop();
+		if (count && key == s->key)
+			count += s->count;
+		else {
+			if (count)
+				w(key.data(), count);
+			key = s->key;
+			count = s->count;
+		}
+		if (s->next())
+			queue.push(s);
+	}
+	if (error) {
+		err << "Error reading temporary file: " << strerror(error) <<
+			std::endl;
+		return false;
+	}
+	if (count)
+		w(key.data(), count);
+	return true;
+}
@@ -0,0 +1,122 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef NGRAMCOUNTER_H
+#define NGRAMCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TokenId.h"
+
+/**
+ * Count the n-grams of the tokens added to it.
+ * N-grams don't span the units (e.g. files or lines) delimited with
+ * end_unit().
+ * The counts are kept in an open-addressing hash table, whose entries
+ * are the n-grams' tokens, packed one after the other, and their counts.
+ * When the table would exceed its memory bound, its entries are sorted
+ * and spilled as a run to an unlinked temporary file.
+ * The runs and tables of several counters, e.g. one for each thread,
+ * are finally merged into a single sorted table.
+ */
+class NgramCounter {
+public:
+	static const unsigned MAX_N = 16;	// Longest n-gram counted
+	// Function receiving an n-gram's tokens and its count
+	typedef std::function<void(const token_type *, uint64_t)> Writer;
+private:
+	unsigned n;			// Number of tokens in each n-gram
+	size_t max_memory;		// Bound of the table's memory
+	/*
+	 * The last n tokens, stored twice, so that they are always
+	 * available in order starting at pos.
+	 */
+	token_type window[2 * MAX_N];
+	unsigned pos;			// Position of the oldest token
+	unsigned ntokens;		// Tokens in the window, up to n
+	/*
+	 * Hash table slots: a hash tag in the high 32 bits,
+	 * and the entry number plus one, or 0 if empty, in the low bits.
+	 */
+	std::vector<uint64_t> slots;
+	std::vector<token_type> keys;	// Tokens of each entry
+	std::vector<uint64_t> counts;	// Count of each entry
+	std::vector<int> runs;		// Descriptors of the spilled runs
+	std::string error;		// First failure to spill a run
+
+	// Return the memory used by a table with the specified slots
+	size_t table_memory(size_t nslots) const;
+	// Count an occurrence of the n-gram key
+	void count(const token_type *key);
+	// Double the table's size; return false if it would exceed the bound
+	bool grow();
+	/*
+	 * Write the table's entries to a run, and empty the table.
+	 * On failure, record the error; the entries are then lost.
+	 */
+	void spill();
+	// Return the entry numbers sorted by their key
+	std::vector<uint32_t> sorted() const;
+public:
+	/**
+	 * Create a counter of n-grams with the specified number of tokens,
+	 * which must be between 1 and MAX_N, whose table uses
+	 * approximately up to the specified number of bytes.
+	 */
+	NgramCounter(unsigned n, size_t max_memory);
+	~NgramCounter();
+	NgramCounter(const NgramCounter &) = delete;
+	NgramCounter &operator=(const NgramCounter &) = delete;
+
+	// Add a token; count the n-gram it ends
+	void add(token_type t) {
+		window[pos] = window[pos + n] = t;
+		if (++pos == n)
+			pos = 0;
+		if (ntokens < n)
+			ntokens++;
+		if (ntokens == n)
+			count(window + pos);
+	}
+
+	// End the current unit; following tokens start new n-grams
+	void end_unit() { ntokens = 0; }
+
+	// Return the number of runs spilled to disk
+	size_t nruns() const { return runs.size(); }
+
+	/**
+	 * Return a description of the first failure to spill a run,
+	 * after which the counts are incomplete, or an empty string.
+	 */
+	const std::string &get_error() const { return error; }
+
+	/**
+	 * Call w with each n-gram counted by the specified counters,
+	 * which must count n-grams of the same length, and its total count,
+	 * in ascending order of the n-grams' tokens.
+	 * Return false, after reporting the error to err, if a counter
+	 * failed to spill a run, or a run can't be read.
+	 */
+	static bool merge(const std::vector<NgramCounter *> &counters,
+		const Writer &w, std::ostream &err);
+};
+#endif /* NGRAMCOUNTER_H */
@@ -0,0 +1,160 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef NGRAMCOUNTERTEST_H
+#define NGRAMCOUNTERTEST_H
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CTokenizer.h"
+#include "Keyword.h"
+#include "NgramCounter.h"
+
+class NgramCounterTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(NgramCounterTest);
+	CPPUNIT_TEST(testCount);
+	CPPUNIT_TEST(testUnits);
+	CPPUNIT_TEST(testUnigrams);
+	CPPUNIT_TEST(testSpill);
+	CPPUNIT_TEST(testSpillFailure);
+	CPPUNIT_TEST(testMerge);
+	CPPUNIT_TEST(testTokenize);
+	CPPUNIT_TEST_SUITE_END();
+
+	// Return the merged counts of the counters as lines of text
+	static std::string counts(const std::vector<NgramCounter *> &c,
+			unsigned n) {
+		std::ostringstream s, err;
+
+		CPPUNIT_ASSERT(NgramCounter::merge(c, [&s, n](
+				const token_type *key, uint64_t count) {
+			for (unsigned i = 0; i < n; i++)
+				s << key[i] << ' ';
+			s << count << '\n';
+		}, err));
+		CPPUNIT_ASSERT_EQUAL(std::string(), err.str());
+		return s.str();
+	}
+
+	// Add a pseudo-random sequence of tokens to the counter
+	static void add_random(NgramCounter &c, unsigned seed, int ntokens) {
+		for (int i = 0; i < ntokens; i++) {
+			seed = seed * 1103515245 + 12345;
+			c.add((seed >> 16) % 300);
+		}
+	}
+public:
+	void testCount() {
+		NgramCounter c(2, 1 << 20);
+
+		for (token_type t : {1, 2, 1, 2, 1, 3})
+			c.add(t);
+		CPPUNIT_ASSERT_EQUAL(std::string("1 2 2\n1 3 1\n2 1 2\n"),
+			counts({&c}, 2));
+	}
+
+	// N-grams don't span units, and units shorter than n have none
+	void testUnits() {
+		NgramCounter c(3, 1 << 20);
+
+		for (token_type t : {1, 2, 3})
+			c.add(t);
+		c.end_unit();
+		for (token_type t : {2, 3})
+			c.add(t);
+		c.end_unit();
+		for (token_type t : {3, 1, 2, 3})
+			c.add(t);
+		CPPUNIT_ASSERT_EQUAL(std::string("1 2 3 2\n3 1 2 1\n"),
+			counts({&c}, 3));
+	}
+
+	void testUnigrams() {
+		NgramCounter c(1, 1 << 20);
+
+		for (token_type t : {0x80000000u, 5u, 5u})
+			c.add(t);
+		CPPUNIT_ASSERT_EQUAL(std::string("5 2\n2147483648 1\n"),
+			counts({&c}, 1));
+	}
+
+	// Tables that exceed their memory bound give the same counts
+	void testSpill() {
+		NgramCounter big(3, 1 << 30);
+		NgramCounter small(3, 64 * 1024);
+
+		add_random(big, 1, 200000);
+		add_random(small, 1, 200000);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), big.nruns());
+		CPPUNIT_ASSERT(small.nruns() > 1);
+		CPPUNIT_ASSERT(counts({&big}, 3) == counts({&small}, 3));
+	}
+
+	// Failing to spill is reported when merging, without exiting
+	void testSpillFailure() {
+		const char *tmpdir = getenv("TMPDIR");
+		std::string saved(tmpdir ? tmpdir : "");
+		NgramCounter c(3, 64 * 1024);
+		std::ostringstream s, err;
+
+		setenv("TMPDIR", "/nonexistent/directory", 1);
+		add_random(c, 1, 200000);
+		if (tmpdir)
+			setenv("TMPDIR", saved.c_str(), 1);
+		else
+			unsetenv("TMPDIR");
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), c.nruns());
+		CPPUNIT_ASSERT(!c.get_error().empty());
+		CPPUNIT_ASSERT(!NgramCounter::merge({&c}, [&s](const token_type *,
+				uint64_t count) { s << count; }, err));
+		CPPUNIT_ASSERT_EQUAL(std::string(), s.str());
+		CPPUNIT_ASSERT(err.str().find("/nonexistent/directory") !=
+			std::string::npos);
+	}
+
+	// The counts of several counters are summed
+	void testMerge() {
+		NgramCounter all(2, 1 << 30);
+		NgramCounter a(2, 1 << 30);
+		NgramCounter b(2, 64 * 1024);
+
+		add_random(all, 1, 50000);
+		all.end_unit();
+		add_random(all, 2, 50000);
+		add_random(a, 1, 50000);
+		add_random(b, 2, 50000);
+		CPPUNIT_ASSERT(counts({&all}, 2) == counts({&a, &b}, 2));
+		CPPUNIT_ASSERT_EQUAL(std::string(), counts({}, 2));
+	}
+
+	// Units are those of the binary output
+	void testTokenize() {
+		NgramCounter c(2, 1 << 20);
+		CTokenizer t("int f() { return 0; }", {"statement"});
+
+		t.ngram_tokenize(c, true);
+		std::ostringstream expect;
+		expect << "123 " << Keyword::K_return << " 1\n" <<
+			Keyword::K_return << ' ' << TokenId::ANY_NUMBER <<
+			" 1\n" << TokenId::ANY_NUMBER << " 59 1\n";
+		CPPUNIT_ASSERT_EQUAL(expect.str(), counts({&c}, 2));
+	}
+};
+#endif /* NGRAMCOUNTERTEST_H */
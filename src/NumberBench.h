@@ -0,0 +1,105 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef NUMBERBENCH_H
+#define NUMBERBENCH_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CharSource.h"
+#include "CTokenizer.h"
+#include "OutputSink.h"
+#include "TokenizerBase.h"
+
+class NumberBench {
+	/*
+	 * Return numeric literals as found in data tables, lookup arrays,
+	 * and test vectors: integers, hexadecimal masks, and
+	 * floating point values with and without exponents.
+	 */
+	static std::vector<std::string> literals(size_t n) {
+		std::vector<std::string> v;
+		uint32_t r = 1;
+		char buff[64];
+
+		v.reserve(n);
+		while (v.size() < n) {
+			r = r * 1103515245 + 12345;
+			switch (v.size() % 5) {
+			case 0:
+				v.push_back(std::to_string(r % 1000));
+				break;
+			case 1:
+				v.push_back(std::to_string(r));
+				break;
+			case 2:
+				snprintf(buff, sizeof(buff), "0x%08x", r);
+				v.push_back(buff);
+				break;
+			case 3:
+				snprintf(buff, sizeof(buff), "%.6f", r / 65536.0);
+				v.push_back(buff);
+				break;
+			case 4:
+				snprintf(buff, sizeof(buff), "%.4e",
+					r / 4294967296.0 * (r % 7 == 0 ? 1e-9 : 1e12));
+				v.push_back(buff);
+				break;
+			}
+		}
+		return v;
+	}
+public:
+	static void run() {
+		std::vector<std::string> nums(literals(1024 * 1024));
+
+		double before = Benchmark::run("Number strtod classification",
+			nums.size(), "number", [&nums]() {
+				size_t n = 0;
+				for (auto &s : nums)
+					n += TokenizerBase::strtod_num_token(s.c_str());
+				return n;
+			});
+		double after = Benchmark::run("Number digit count classification",
+			nums.size(), "number", [&nums]() {
+				size_t n = 0;
+				for (auto &s : nums)
+					n += TokenizerBase::num_token(s);
+				return n;
+			});
+		Benchmark::speedup(before, after);
+
+		// A C data table holding the same numbers
+		std::string code("static const double table[] = {\n");
+		for (auto &s : nums)
+			code += "\t" + s + ",\n";
+		code += "};\n";
+		Benchmark::run("C tokenizer on a numeric table", nums.size(),
+			"number", [&code]() {
+				CharSource cs(code.data(), code.size());
+				CTokenizer t(cs, "bench");
+				OutputSink out;
+				t.set_output(out);
+				t.numeric_tokenize(false);
+				return out.str().size();
+			});
+	}
+};
+#endif /* NUMBERBENCH_H */
@@ -0,0 +1,58 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "OutputSink.h"
+
+// Return a sink for the program's standard output
+OutputSink &
+OutputSink::standard_output()
+{
+	static OutputSink out(STDOUT_FILENO);
+
+	return out;
+}
+
+// Write any buffered data to the file descriptor
+void
+OutputSink::flush()
+{
+	if (fd == -1)
+		return;
+
+	const char *p = buffer.data();
+	size_t len = buffer.size();
+	while (len > 0) {
+		ssize_t n = ::write(fd, p, len);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			std::cerr << "Output error: " << strerror(errno) <<
+				std::endl;
+			// Also called when exiting, where exit() isn't allowed
+			_exit(EXIT_FAILURE);
+		}
+		p += n;
+		len -= n;
+	}
+	buffer.clear();
+}
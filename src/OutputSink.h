@@ -0,0 +1,117 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "TokenId.h"
+
+/**
+ * A destination for the tokenizer's output.
+ * Output is accumulated in a large buffer, which is written to the
+ * sink's file descriptor only when it fills up, when it is explicitly
+ * flushed, or when the sink is destroyed.
+ * A sink without a file descriptor keeps all its output in memory.
+ */
+class OutputSink {
+	int fd;			// Output file descriptor, or -1 for memory
+	std::string buffer;	// Data not yet written
+	static const size_t BUFFER_SIZE = 1024 * 1024;
+
+	// Write out the buffer if it has filled up
+	void check_full() {
+		if (buffer.size() >= BUFFER_SIZE && fd != -1)
+			flush();
+	}
+public:
+	/** Construct a sink writing to the specified file descriptor */
+	OutputSink(int f = -1) : fd(f) {
+		if (fd != -1)
+			buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+	}
+
+	OutputSink(const OutputSink &) = delete;
+	OutputSink &operator=(const OutputSink &) = delete;
+
+	~OutputSink() { flush(); }
+
+	/** Return a sink for the program's standard output */
+	static OutputSink &standard_output();
+
+	OutputSink &operator<<(char c) {
+		buffer.push_back(c);
+		check_full();
+		return *this;
+	}
+
+	OutputSink &operator<<(std::string_view s) {
+		buffer.append(s);
+		check_full();
+		return *this;
+	}
+
+	OutputSink &operator<<(const char *s) {
+		buffer.append(s);
+		check_full();
+		return *this;
+	}
+
+	/** Append the specified bytes */
+	OutputSink &write(const char *data, size_t size) {
+		buffer.append(data, size);
+		check_full();
+		return *this;
+	}
+
+	OutputSink &operator<<(token_type n) {
+		char digits[16];
+		auto r = std::to_chars(digits, digits + sizeof(digits), n);
+		buffer.append(digits, r.ptr - digits);
+		check_full();
+		return *this;
+	}
+
+	OutputSink &operator<<(uint64_t n) {
+		char digits[24];
+		auto r = std::to_chars(digits, digits + sizeof(digits), n);
+		buffer.append(digits, r.ptr - digits);
+		check_full();
+		return *this;
+	}
+
+	OutputSink &operator<<(int n) {
+		char digits[16];
+		auto r = std::to_chars(digits, digits + sizeof(digits), n);
+		buffer.append(digits, r.ptr - digits);
+		check_full();
+		return *this;
+	}
+
+	/** Write any buffered data to the file descriptor */
+	void flush();
+
+	/** Return the data held by a memory sink */
+	const std::string &str() const { return buffer; }
+
+	/** Discard the data held by a memory sink */
+	void clear() { buffer.clear(); }
+};
+#endif /* OUTPUTSINK_H */
@@ -0,0 +1,101 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef OUTPUTSINKTEST_H
+#define OUTPUTSINKTEST_H
+
+#include <cstdio>
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CTokenizer.h"
+#include "OutputSink.h"
+
+class OutputSinkTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(OutputSinkTest);
+	CPPUNIT_TEST(testMemory);
+	CPPUNIT_TEST(testNumbers);
+	CPPUNIT_TEST(testFile);
+	CPPUNIT_TEST(testLarge);
+	CPPUNIT_TEST(testTokenizer);
+	CPPUNIT_TEST_SUITE_END();
+
+	// Return the contents of the specified file
+	static std::string contents(FILE *f) {
+		std::string s;
+		int c;
+
+		rewind(f);
+		while ((c = getc(f)) != EOF)
+			s += (char)c;
+		return s;
+	}
+public:
+	void testMemory() {
+		OutputSink o;
+
+		o << 'a' << "bc" << std::string("de");
+		CPPUNIT_ASSERT_EQUAL(std::string("abcde"), o.str());
+		o.clear();
+		CPPUNIT_ASSERT_EQUAL(std::string(""), o.str());
+	}
+
+	void testNumbers() {
+		OutputSink o;
+
+		o << static_cast<token_type>(0) << ' ' <<
+			static_cast<token_type>(4294967295u) << ' ' << -42;
+		CPPUNIT_ASSERT_EQUAL(std::string("0 4294967295 -42"), o.str());
+	}
+
+	void testFile() {
+		FILE *f = tmpfile();
+		OutputSink o(fileno(f));
+
+		o << "hello" << '\n';
+		CPPUNIT_ASSERT_EQUAL(std::string(""), contents(f));
+		o.flush();
+		CPPUNIT_ASSERT_EQUAL(std::string("hello\n"), contents(f));
+		fclose(f);
+	}
+
+	// Output exceeding the buffer size gets written without a flush
+	void testLarge() {
+		FILE *f = tmpfile();
+		OutputSink o(fileno(f));
+		const std::string line(1000, 'x');
+
+		for (int i = 0; i < 2000; i++)
+			o << line;
+		CPPUNIT_ASSERT(contents(f).size() > 0);
+		o.flush();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2000 * 1000),
+			contents(f).size());
+		fclose(f);
+	}
+
+	void testTokenizer() {
+		OutputSink o;
+		CTokenizer ct("int main() { return 0; }", {"statement"});
+
+		ct.set_output(o);
+		ct.set_separator(' ');
+		ct.symbolic_tokenize();
+		CPPUNIT_ASSERT_EQUAL(std::string("{ return 0 ;\n}\n\n"), o.str());
+	}
+};
+#endif /* OUTPUTSINKTEST_H */
@@ -81,18 +81,20 @@ PHPTokenizer::process_here_document()
 	}
 }
 
+template <bool AllContents>
 inline token_type
-PHPTokenizer::get_immediate_token()
+PHPTokenizer::lex_token()
 {
-	char c0, c1, c2;
+	char c0, c1;
 	Keyword::IdentifierType key;
 	std::string lcase;
+	token_type op;
 
 	for (;;) {
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -108,241 +110,41 @@ PHPTokenizer::get_immediate_token()
 		case ' ': case '\t': case '\v': case '\f': case '\r':
 			break;
 		case '#':				/* # line comment */
-			return get_line_comment_token();
-		/*
-		 * Double character PHP tokens with more than 2 different outcomes
-		 * (e.g. &, &=, &&)
-		 */
-		case '&':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '&':
-				return Token::BOOLEAN_AND; // &&
-			case '=':
-				return Token::AND_EQUAL; // &=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '|':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '|':
-				return Token::BOOLEAN_OR; // ||
-			case '=':
-				return Token::OR_EQUAL; // |=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '+':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '+':
-				return Token::PLUS_PLUS; // ++
-			case '=':
-				return Token::PLUS_EQUAL; // +=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '-':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '-':
-				return Token::MINUS_MINUS; // --
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			case '>':
-				return Token::RIGHT_SLIM_ARROW; // ->
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Simple single/double character tokens (e.g. ?, ??) */
-		case '?':
+			return get_line_comment_token<AllContents>();
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case '=': case '>': case '?': case '^': case '|':
 			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '?')
-				return Token::NULL_COALESCE; // ??
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '^':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '%':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Operators starting with < or > or = or ! or * */
-		case '>':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::GREATER_EQUAL; // >=
-			case '>':
-				src.get(c1);
-				if (c1 == '=')
-					return Token::RSHIFT_ARITHMETIC_EQUAL; // >>=
-				else {
-					src.push(c1);
-					return Token::RSHIFT_ARITHMETIC; // >>
-				}
-				break;
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '=':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=') {
-				src.get(c1);
-				if (c1 == '=')
-					return Token::IDENTICAL; // ===
-				else {
-					src.push(c1);
-					return Token::EQUAL; // ==
-				}
-			} else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '!':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=') {
-				src.get(c1);
-				if (c1 == '=')
-					return Token::NOT_IDENTICAL; // !==
-				else {
-					src.push(c1);
-					return Token::NOT_EQUAL; // !=
-				}
-			} else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '*':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '*':
-				src.get(c1);
-				if (c1 == '=')
-					return Token::RAISE_EQUAL; // **=
-				else {
-					src.push(c1);
-					return Token::RAISE; // **
-				}
-			case '=':
-				return Token::TIMES_EQUAL; // *=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_operator_token(c0, Operator::PHP);
 		case '<':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				src.get(c1);
-				if (c1 == '>')
-					return Token::SPACESHIP; // <=>
-				else {
-					src.push(c1);
-					return Token::LESS_EQUAL; // <=
-				}
-				break;
-			case '<':
-				src.get(c1);
-				switch (c1) {
-				case '=':
-					return Token::LSHIFT_EQUAL; // <<=
-				case '<':
-					if (process_here_document())
-						return Token::HERE_DOCUMENT; // <<<...
-					else {
-						error("EOF encountered while processing a here document");
-						return 0;
-					}
-				default:
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-				break;
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+			op = get_operator_token(c0, Operator::PHP);
+			if (op != Token::HERE_DOCUMENT)
+				return op;
+			if (process_here_document())
+				return Token::HERE_DOCUMENT; // <<<...
+			else {
+				error("EOF encountered while processing a here document");
+				return 0;
 			}
-			break;
 		/* Comments and / operators */
 		case '/':
 			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':		/* /= */
-				return Token::DIV_EQUAL; // /=
+			switch (src.peek()) {
 			case '*':		/* Block comment */
-				return get_block_comment_token();
+				src.get(c1);
+				return get_block_comment_token<AllContents>();
 			case '/':		/* Line comment */
-				return get_line_comment_token();
-			default:				/* / */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+				src.get(c1);
+				return get_line_comment_token<AllContents>();
+			default:		/* / /= */
+				return get_operator_token(c0, Operator::PHP);
 			}
-			break;
-		case '.':	/* . and ... */
+		case '.':	/* . .= and ... */
 			bol.saw_non_space();
-			src.get(c1);
-			if (isdigit(c1)) {
-				val = std::string(".") + (char)(c1);
-				return get_number_token(val);
-			}
-			switch (c1) {
-			case '.':
-				src.get(c2);
-				if (c2 != '.') {
-					src.push(c2);
-					src.push(c1);
-					return static_cast<token_type>(c0);
-				}
-				return Token::ELIPSIS; // ...
-			case '=':
-				return Token::CONCAT_EQUALS; // .=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
+			if (isdigit(src.peek()))
+				return get_number_token(c0);
+			return get_operator_token(c0, Operator::PHP);
 		/* XXX Can also be non-ASCII */
 		case '$': case '\\':
 		case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
@@ -355,32 +157,25 @@ PHPTokenizer::get_immediate_token()
 		case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
 		case 'V': case 'W': case 'X': case 'Y': case 'Z':
 			bol.saw_non_space();
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				// Namespace prefix treated as single name
-				if (!isalnum(c0) && c0 != '_' && c0 != '\\')
-					break;
-				val += c0;
-			}
-			src.push(c0);
+			// Namespace prefix treated as single name
+			get_word_value(c0, identifier_chars);
 
-			lcase = val;
+			lcase = value;
 			std::transform(lcase.begin(), lcase.end(), lcase.begin(), ::tolower);
 			key = keyword.identifier_type(lcase);
 			if (key == Keyword::FIRST_IDENTIFIER)
-				return symbols.value(val);
+				return symbols.value(value);
 			else
 				return key;
 			break;
 		case '\'':
 			bol.saw_non_space();
-			if (process_char_literal())
+			if (process_char_literal<AllContents>())
 				return Token::CHAR_LITERAL; // '.'
 			else
 				return 0;
 		case '"':
-			if (process_string_literal())
+			if (process_string_literal<AllContents>())
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
@@ -388,8 +183,7 @@ PHPTokenizer::get_immediate_token()
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
 			bol.saw_non_space();
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
@@ -400,3 +194,7 @@ PHPTokenizer::get_immediate_token()
 PHPTokenizer::~PHPTokenizer()
 {
 }
+
+template token_type PHPTokenizer::lex_token<false>();
+template token_type PHPTokenizer::lex_token<true>();
+template class TokenizerImpl<PHPTokenizer>;
@@ -24,15 +24,18 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class PHPTokenizer : public TokenizerBase {
+class PHPTokenizer : public TokenizerImpl<PHPTokenizer> {
 private:
 	Token php_token;
+	// Names can also contain namespace separators
+	static constexpr ByteScan::WordChars identifier_chars{'_', '\\'};
 	bool process_here_document();
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -49,14 +52,15 @@ public:
 	// Construct from a character source
 	PHPTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_PHP, s, file_name, opt) {}
+		TokenizerImpl(Keyword::L_PHP, s, file_name, opt) {}
 
 	// Construct for a string source
 	PHPTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_PHP, s, opt) {}
+		TokenizerImpl(Keyword::L_PHP, s, opt) {}
 
 	~PHPTokenizer();
 
 	friend class PHPTokenizerTest;
 };
+extern template class TokenizerImpl<PHPTokenizer>;
 #endif /* PHPTOKENIZER_H */
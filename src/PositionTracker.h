@@ -0,0 +1,92 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef POSITIONTRACKER_H
+#define POSITIONTRACKER_H
+
+#include <cstdint>
+
+#include "CharSource.h"
+
+// The position of a token's first character
+struct Position {
+	uint64_t line;		// Line number, starting at 1
+	uint64_t column;	// Byte column, starting at 1; 0 if unknown
+	uint64_t offset;	// Byte offset from the start of the input
+};
+
+/**
+ * Find the position of the tokens that lexers return.
+ * Lexers silently skip only whitespace and non-ASCII characters before
+ * a token; with all contents horizontal space is returned as tokens.
+ * A token therefore starts at the first character not skipped after
+ * the input consumed before lexing it, and this is located in the input
+ * buffer only when positions are requested, leaving the lexers as they
+ * are.
+ * The start of each line is found by scanning backward from its first
+ * token, once for every line.
+ */
+class PositionTracker {
+	CharSource &src;
+	uint64_t start;		// Input offset before lexing the token
+	uint64_t start_line;	// Line number at start
+	uint64_t known_line;	// Line whose starting offset is known, or 0
+	uint64_t line_start;	// Offset of known_line's first character
+public:
+	PositionTracker(CharSource &s) : src(s), start(0), start_line(1),
+		known_line(1), line_start(0) {}
+
+	// Call before lexing a token
+	void before_token() {
+		start = src.get_nchar();
+		start_line = src.line_number();
+	}
+
+	// Return the position of the token lexed after before_token()
+	Position token_position(bool all_contents) {
+		Position pos{start_line, 0, start};
+		const char *p = src.address(start);
+
+		if (!p)
+			return pos;
+		for (const char *end = src.data_end(); p < end; p++) {
+			char c = *p;
+			if (c == '\n') {
+				pos.line++;
+				known_line = pos.line;
+				line_start = src.offset(p) + 1;
+			} else if (!((c & 0x80) || c == '\r' || c == '\v' ||
+			    c == '\f' ||
+			    (!all_contents && (c == ' ' || c == '\t'))))
+				break;
+		}
+		pos.offset = src.offset(p);
+
+		if (pos.line != known_line) {
+			const char *q = p;
+			const char *begin = src.data_begin();
+			while (q > begin && q[-1] != '\n')
+				q--;
+			if (q == begin && src.offset(begin) != 0)
+				return pos;	// The line's start is no longer available
+			known_line = pos.line;
+			line_start = src.offset(q);
+		}
+		pos.column = pos.offset - line_start + 1;
+		return pos;
+	}
+};
+#endif /* POSITIONTRACKER_H */
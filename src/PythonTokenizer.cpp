@@ -25,25 +25,25 @@
 #include "Token.h"
 
 /*
- * Return true if val represent a valid string or byte literal prefix
+ * Return true if value represents a valid string or byte literal prefix
  * i.e. one of the following.
  * "r" | "u" | "R" | "U" | "f" | "F"
  * | "fr" | "Fr" | "fR" | "FR" | "rf" | "rF" | "Rf" | "RF"
  * "b" | "B" | "br" | "Br" | "bR" | "BR" | "rb" | "rB" | "Rb" | "RB"
  */
 inline bool
-PythonTokenizer::val_is_string_prefix()
+PythonTokenizer::value_is_string_prefix()
 {
-	int len = val.length();
+	int len = value.length();
 
 	if (len > 2)
 		return false;
-	switch (val[0]) {
+	switch (value[0]) {
 	case 'B':
 	case 'F':
 		if (len == 1)
 			return true;
-		switch (val[1]) {
+		switch (value[1]) {
 			case 'R': // BR, FR
 			case 'r': // Br, Fr
 				return true;
@@ -53,7 +53,7 @@ PythonTokenizer::val_is_string_prefix()
 	case 'r':
 		if (len == 1)
 			return true;
-		switch (val[1]) {
+		switch (value[1]) {
 			case 'B': // RB, rB
 			case 'F': // RF, rF
 			case 'b': // Rb, rb
@@ -71,7 +71,7 @@ PythonTokenizer::val_is_string_prefix()
 	case 'f':
 		if (len == 1)
 			return true;
-		switch (val[1]) {
+		switch (value[1]) {
 			case 'R': // bR, fR
 			case 'r': // br, fr
 				return true;
@@ -82,6 +82,7 @@ PythonTokenizer::val_is_string_prefix()
 }
 
 // Process a Python string literal starting with c, returning false on EOF
+template <bool AllContents>
 bool
 PythonTokenizer::process_string_literal(char c)
 {
@@ -90,7 +91,7 @@ PythonTokenizer::process_string_literal(char c)
 
 	c1 = c2 = 0;
 	bol.saw_non_space();
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	for (;;) {
 		if (!src.get(c0)) {
@@ -100,7 +101,7 @@ PythonTokenizer::process_string_literal(char c)
 		if (c0 == '\\') {
 			// Consume one character after the backslash
 			src.get(c0);
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 			continue;
 		} else if (c0 == c) {
@@ -125,11 +126,11 @@ PythonTokenizer::process_string_literal(char c)
 		}
 		c2 = c1;
 		c1 = c0;
-		if (all_contents) {
+		if constexpr (AllContents) {
 			sequence_hash.add(c0);
 		}
 	}
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 	return true;
 }
@@ -138,17 +139,18 @@ PythonTokenizer::process_string_literal(char c)
  * Main tokenizer loop, based on the rules specified in
  * https://docs.python.org/3/reference/lexical_analysis.html
  */
+template <bool AllContents>
 inline token_type
-PythonTokenizer::get_immediate_token()
+PythonTokenizer::lex_token()
 {
-	char c0, c1, c2;
+	char c0;
 	Keyword::IdentifierType key;
 
 	for (;;) {
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -159,202 +161,18 @@ PythonTokenizer::get_immediate_token()
 		case ' ': case '\t': case '\v': case '\f': case '\r':
 			break;
 		case '#':				/* Line comment */
-			return get_line_comment_token();
-		/*
-		 * Double character tokens with more than 2 different outcomes
-		 */
-		case '-':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			case '>':
-				return Token::RIGHT_SLIM_ARROW; // ->
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Simple single/double character tokens (e.g. !, !=) */
-		case '!':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::NOT_EQUAL; // !=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '%':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '&':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::AND_EQUAL; // &=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '@':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::AT_EQUAL; // @=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '^':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_line_comment_token<AllContents>();
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case '/': case '<': case '=': case '>': case '@': case '^':
 		case '|':
 			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::OR_EQUAL; // |=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '=':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::EQUAL; // ==
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '+':
-			bol.saw_non_space();
-			src.get(c1);
-			if (c1 == '=')
-				return Token::PLUS_EQUAL; // +=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Operators starting with * or / */
-		case '*':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::TIMES_EQUAL; 		// *=
-			case '*':
-				src.get(c1);
-				if (c1 == '=')
-					return Token::RAISE_EQUAL;	// **=
-				else {
-					src.push(c1);
-					return Token::RAISE;		// **
-				}
-			default:					// *
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '/':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::DIV_EQUAL; 		// /=
-			case '/':
-				src.get(c1);
-				if (c1 == '=')
-					return Token::DIV_FLOOR_EQUAL;	// //=
-				else {
-					src.push(c1);
-					return Token::DIV_FLOOR;	// //
-				}
-			default:					// /
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		/* Operators starting with < or > */
-		case '>':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* >= */
-				return Token::GREATER_EQUAL; // >=
-			case '>':
-				src.get(c1);
-				if (c1 == '=')
-					return Token::RSHIFT_ARITHMETIC_EQUAL; // >>=
-				else {
-					src.push(c1);
-					return Token::RSHIFT_ARITHMETIC; // >>
-				}
-				break;
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
-		case '<':
-			bol.saw_non_space();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* <= */
-				return Token::LESS_EQUAL; // <=
-			case '<':
-				src.get(c1);
-				if (c1 == '=')			/* <<= */
-					return Token::LSHIFT_EQUAL; // <<=
-				else {			/* << */
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-				break;
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			break;
+			return get_operator_token(c0, Operator::Python);
 		case '.':	/* . and ... */
 			bol.saw_non_space();
-			src.get(c1);
-			if (isdigit(c1)) {
-				val = std::string(".") + (char)(c1);
-				return get_number_token(val);
-			}
-			if (c1 != '.') {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			src.get(c2);
-			if (c2 != '.') {
-				src.push(c2);
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-			return Token::ELIPSIS; // ...
+			if (isdigit(src.peek()))
+				return get_number_token(c0);
+			return get_operator_token(c0, Operator::Python);
 		/* XXX Can also be non-ASCII */
 		case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
 		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k':
@@ -366,28 +184,23 @@ PythonTokenizer::get_immediate_token()
 		case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
 		case 'V': case 'W': case 'X': case 'Y': case 'Z':
 			bol.saw_non_space();
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				if (!isalnum(c0) && c0 != '_')
-					break;
-				val += c0;
-			}
+			get_word_value(c0, identifier_chars);
+			src.get(c0);
 
 			// Handle prefixed string literals
 			if ((c0 == '\'' || c0 == '"') &&
-					val_is_string_prefix()) {
-				if (process_string_literal(c0))
+					value_is_string_prefix()) {
+				if (process_string_literal<AllContents>(c0))
 					return Token::STRING_LITERAL; // \"...\"
 				else
 					return 0;
 			}
 
 			src.push(c0);
-			key = keyword.identifier_type(val);
+			key = keyword.identifier_type(value);
 			switch (key) {
 			case Keyword::FIRST_IDENTIFIER:
-				return symbols.value(val);
+				return symbols.value(value);
 			case Keyword::K_class:
 				nesting.saw_class();
 				return key;
@@ -397,7 +210,7 @@ PythonTokenizer::get_immediate_token()
 			break;
 		case '\'':
 		case '"':
-			if (process_string_literal(c0))
+			if (process_string_literal<AllContents>(c0))
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
@@ -405,8 +218,7 @@ PythonTokenizer::get_immediate_token()
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
 			bol.saw_non_space();
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			bol.saw_non_space();
 			return static_cast<token_type>(c0);
@@ -417,3 +229,7 @@ PythonTokenizer::get_immediate_token()
 PythonTokenizer::~PythonTokenizer()
 {
 }
+
+template token_type PythonTokenizer::lex_token<false>();
+template token_type PythonTokenizer::lex_token<true>();
+template class TokenizerImpl<PythonTokenizer>;
@@ -24,16 +24,17 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class PythonTokenizer : public TokenizerBase {
+class PythonTokenizer : public TokenizerImpl<PythonTokenizer> {
 private:
 	Token python_token;
-	bool val_is_string_prefix();
-	bool process_string_literal(char c);
+	bool value_is_string_prefix();
+	template <bool AllContents> bool process_string_literal(char c);
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -50,14 +51,15 @@ public:
 	// Construct from a character source
 	PythonTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Python, s, file_name, opt) {}
+		TokenizerImpl(Keyword::L_Python, s, file_name, opt) {}
 
 	// Construct for a string source
 	PythonTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Python, s, opt) {}
+		TokenizerImpl(Keyword::L_Python, s, opt) {}
 
 	~PythonTokenizer();
 
 	friend class PythonTokenizerTest;
 };
+extern template class TokenizerImpl<PythonTokenizer>;
 #endif /* PYTHONTOKENIZER_H */
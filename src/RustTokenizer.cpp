@@ -28,6 +28,7 @@
  * Process a single quote literal, returning associated tokens
  * This can be CHAR_LITERAL, '\'' lifetime-id or label-id ':'
  */
+template <bool AllContents>
 token_type
 RustTokenizer::get_single_quote_literal()
 {
@@ -36,15 +37,16 @@ RustTokenizer::get_single_quote_literal()
 	bool starts_with_alnum = false;
 	int index = 0;
 
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	val = "";
 	for (;;) {
 		if (!src.get(c0)) {
 			error("EOF encountered while processing a character literal");
+			value = val;
 			return 0;
 		}
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c0);
 
 		if (c0 == '\\') {
@@ -52,7 +54,7 @@ RustTokenizer::get_single_quote_literal()
 			// ... to deal with the '\'' problem
 			src.get(c0);
 			++index;
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 			continue;
 		}
@@ -60,7 +62,7 @@ RustTokenizer::get_single_quote_literal()
 		if (c0 == '\'') {
 			// Character literals '.*'
 			ret = Token::CHAR_LITERAL; // '.'
-			if (all_contents)
+			if constexpr (AllContents)
 				push_token(sequence_hash.get());
 			break;
 		}
@@ -88,6 +90,7 @@ RustTokenizer::get_single_quote_literal()
 		val += c0;
 		++index;
 	}
+	value = val;
 	return ret;
 }
 
@@ -97,28 +100,29 @@ RustTokenizer::get_single_quote_literal()
  * Delimiter will be one of " or '.
  * Return true on success false on error (EOF).
  */
+template <bool AllContents>
 bool
 RustTokenizer::process_literal(char delimiter, int delimiter_hash_count)
 {
 	bool saw_delimiter = false;
 	int hash_count = 0;
-	bool raw = (val == "r" || val == "br");
+	bool raw = (value == "r" || value == "br");
 	char c0;
 
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	for (;;) {
 		if (!src.get(c0)) {
 			error("EOF encountered while processing a literal");
 			return false;
 		}
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c0);
 
 		if (!raw && c0 == '\\') {
 			// Consume one character after the backslash
 			src.get(c0);
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 			continue;
 		}
@@ -135,7 +139,7 @@ RustTokenizer::process_literal(char delimiter, int delimiter_hash_count)
 		}
 
 		if (saw_delimiter && hash_count == delimiter_hash_count) {
-			if (all_contents)
+			if constexpr (AllContents)
 				push_token(sequence_hash.get());
 			return true;
 		}
@@ -147,6 +151,7 @@ RustTokenizer::process_literal(char delimiter, int delimiter_hash_count)
  * prefixed with b, r#*, or br#*
  * c0 is the first non-identifier character.  It will be one of " ' #.
  */
+template <bool AllContents>
 token_type
 RustTokenizer::get_rb_prefixed_token(char c0)
 {
@@ -164,50 +169,46 @@ RustTokenizer::get_rb_prefixed_token(char c0)
 
 	switch (c0) {
 	case '\'':
-		if (!process_literal(c0, hash_count))
+		if (!process_literal<AllContents>(c0, hash_count))
 			return 0;
-		if (val == "b" || val == "br")
+		if (value == "b" || value == "br")
 			return Token::BYTE_LITERAL; // b'.'
 		else
 			return Token::CHAR_LITERAL; // '.'
 		break;
 	case '"':
-		if (!process_literal(c0, hash_count))
+		if (!process_literal<AllContents>(c0, hash_count))
 			return 0;
-		if (val == "b" || val == "br")
+		if (value == "b" || value == "br")
 			return Token::BYTE_STRING_LITERAL; // b\"...\"
 		else
 			return Token::STRING_LITERAL; // \"...\"
 		break;
 	default:
-		val = c0;
-		for (;;) {
-			src.get(c0);
-			if (!isalnum(c0) && c0 != '_')
-				break;
-			val += c0;
-		}
-		if (!val.length()) {
+		get_word_value(c0, identifier_chars);
+		src.get(c0);
+		if (!value.length()) {
 			error("Invalid content for raw prefix");
 			return 0;
 		}
 
 		src.push(c0);
-		return symbols.value(val);
+		return symbols.value(value);
 	}
 }
 
+template <bool AllContents>
 inline token_type
-RustTokenizer::get_immediate_token()
+RustTokenizer::lex_token()
 {
-	char c0, c1, c2;
+	char c0, c1;
 	Keyword::IdentifierType key;
 
 	for (;;) {
 		if (!src.get(c0))
 			return 0;
 
-		if (all_contents) {
+		if constexpr (AllContents) {
 			token_type t = rle.add(c0);
 			if (t)
 				return t;
@@ -227,176 +228,30 @@ RustTokenizer::get_immediate_token()
 			symbols.exit_scope();
 			nesting.saw_close_brace();
 			return static_cast<token_type>(c0);
-		/*
-		 * Double character C tokens with more than 2 different outcomes
-		 * (e.g. -, -=, ->)
-		 */
-		case '-':
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::MINUS_EQUAL; // -=
-			case '>':
-				return Token::RIGHT_SLIM_ARROW; // ->
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '&':
-			src.get(c1);
-			switch (c1) {
-			case '&':
-				return Token::BOOLEAN_AND; // &&
-			case '=':
-				return Token::AND_EQUAL; // &=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '|':
-			src.get(c1);
-			switch (c1) {
-			case '|':
-				return Token::BOOLEAN_OR; // ||
-			case '=':
-				return Token::OR_EQUAL; // |=
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '=':
-			src.get(c1);
-			switch (c1) {
-			case '=':
-				return Token::EQUAL; // ==
-			case '>':
-				return Token::RIGHT_FAT_ARROW; // =>
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		/* Simple single/double character tokens (e.g. !, !=) */
-		case '!':
-			src.get(c1);
-			if (c1 == '=')
-				return Token::NOT_EQUAL; // !=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '+':
-			src.get(c1);
-			if (c1 == '=')
-				return Token::PLUS_EQUAL; // +=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '%':
-			src.get(c1);
-			if (c1 == '=')
-				return Token::MOD_EQUAL; // %=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '*':
-			src.get(c1);
-			if (c1 == '=')
-				return Token::TIMES_EQUAL; // *=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case ':':
-			src.get(c1);
-			if (c1 == ':')
-				return Token::DOUBLE_COLON; // ::
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '^':
-			src.get(c1);
-			if (c1 == '=')
-				return Token::XOR_EQUAL; // ^=
-			else {
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		/* Operators starting with < or > */
+		/* Operators recognized through the language's operator table */
+		case '!': case '%': case '&': case '*': case '+': case '-':
+		case ':': case '<': case '=': case '^': case '|':
+			return get_operator_token(c0, Operator::Rust);
 		case '>':
 			// class might have been used as a template argument
 			nesting.unsaw_class();
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* >= */
-				return Token::GREATER_EQUAL; // >=
-			case '>':
-				src.get(c1);
-				if (c1 == '=')			/* >>= */
-					return Token::RSHIFT_EQUAL; // >>=
-				else {			/* << */
-					src.push(c1);
-					return Token::RSHIFT; // >>
-				}
-			default:				/* > */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
-		case '<':
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* <= */
-				return Token::LESS_EQUAL; // <=
-			case '<':
-				src.get(c1);
-				if (c1 == '=')			/* <<= */
-					return Token::LSHIFT_EQUAL; // <<=
-				else {			/* << */
-					src.push(c1);
-					return Token::LSHIFT; // <<
-				}
-			default:				/* < */
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
+			return get_operator_token(c0, Operator::Rust);
 		/* Comments and / operators */
 		case '/':
-			src.get(c1);
-			switch (c1) {
-			case '=':				/* /= */
-				return Token::DIV_EQUAL; // /=
+			switch (src.peek()) {
 			case '*':				/* Block comment */
-				return get_block_comment_token();
+				src.get(c1);
+				return get_block_comment_token<AllContents>();
 			case '/':				/* Line comment */
-				return get_line_comment_token();
-			default:				/* / */
-				src.push(c1);
-				return static_cast<token_type>(c0);
+				src.get(c1);
+				return get_line_comment_token<AllContents>();
+			default:				/* / /= */
+				return get_operator_token(c0, Operator::Rust);
 			}
 		case '.':	/* . .. ..= ... */
-			src.get(c1);
-			switch (c1) {
-			case '0': case '1': case '2': case '3': case '4':
-			case '5': case '6': case '7': case '8': case '9':
-				val = std::string(".") + (char)(c1);
-				return get_number_token(val);
-			case '.':  /* .. */
-				src.get(c2);
-				switch (c2) {
-				case '.':
-					return Token::ELIPSIS; // ...
-				case '=':
-					return Token::DOT_DOT_EQUAL; // ..=
-				default:
-					src.push(c2);
-					return Token::DOT_DOT; // ..
-				}
-			default:
-				src.push(c1);
-				return static_cast<token_type>(c0);
-			}
+			if (isdigit(src.peek()))
+				return get_number_token(c0);
+			return get_operator_token(c0, Operator::Rust);
 		/* XXX Can also be non-ASCII */
 		case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
 		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k':
@@ -407,38 +262,32 @@ RustTokenizer::get_immediate_token()
 		case 'J': case 'K': case 'L': case 'M': case 'N': case 'O':
 		case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
 		case 'V': case 'W': case 'X': case 'Y': case 'Z':
-			val = c0;
-			for (;;) {
-				src.get(c0);
-				if (!isalnum(c0) && c0 != '_')
-					break;
-				val += c0;
-			}
+			get_word_value(c0, identifier_chars);
+			src.get(c0);
 			if ((c0 == '#' || c0 == '\'' || c0 == '"')
-			    && (val == "r" || val == "b" || val == "br"))
-				return get_rb_prefixed_token(c0);
+			    && (value == "r" || value == "b" || value == "br"))
+				return get_rb_prefixed_token<AllContents>(c0);
 
 			// Single _ has special meaning, so return it as a token
-			if (val == "_")
+			if (value == "_")
 				return static_cast<token_type>('_');
 
 			src.push(c0);
-			key = keyword.identifier_type(val);
+			key = keyword.identifier_type(value);
 			if (key == Keyword::FIRST_IDENTIFIER)
-				return symbols.value(val);
+				return symbols.value(value);
 			return key;
 		case '\'':
-			return get_single_quote_literal();
+			return get_single_quote_literal<AllContents>();
 		case '"':
-			if (process_string_literal())
+			if (process_string_literal<AllContents>())
 				return Token::STRING_LITERAL; // \"...\"
 			else
 				return 0;
 		/* Various numbers */
 		case '0': case '1': case '2': case '3': case '4':
 		case '5': case '6': case '7': case '8': case '9':
-			val = c0;
-			return get_number_token(val);
+			return get_number_token(c0);
 		default:
 			return static_cast<token_type>(c0);
 		}
@@ -448,3 +297,7 @@ RustTokenizer::get_immediate_token()
 RustTokenizer::~RustTokenizer()
 {
 }
+
+template token_type RustTokenizer::lex_token<false>();
+template token_type RustTokenizer::lex_token<true>();
+template class TokenizerImpl<RustTokenizer>;
@@ -24,19 +24,20 @@
 #include "CharSource.h"
 #include "Keyword.h"
 #include "Token.h"
-#include "TokenizerBase.h"
+#include "TokenizerImpl.h"
 
 /** Split input into language-specific tokens */
-class RustTokenizer : public TokenizerBase {
+class RustTokenizer : public TokenizerImpl<RustTokenizer> {
 private:
 	Token rust_token;
 
 	// Process literals and raw identifiers
-	token_type get_rb_prefixed_token(char c0);
-	bool process_literal(char delimiter, int delimiter_hash_count);
-	token_type get_single_quote_literal();
+	template <bool AllContents> token_type get_rb_prefixed_token(char c0);
+	template <bool AllContents> bool process_literal(char delimiter, int delimiter_hash_count);
+	template <bool AllContents> token_type get_single_quote_literal();
 public:
-	token_type get_immediate_token();		// Return a single token
+	// Return a single token, including contents when AllContents is set
+	template <bool AllContents> token_type lex_token();
 
 	const std::string & keyword_to_string(token_type k) const {
 		return keyword.to_string(k);
@@ -53,14 +54,15 @@ public:
 	// Construct from a character source
 	RustTokenizer(CharSource &s, const std::string &file_name,
 			std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Rust, s, file_name, opt) {}
+		TokenizerImpl(Keyword::L_Rust, s, file_name, opt) {}
 
 	// Construct for a string source
 	RustTokenizer(const std::string &s, std::vector<std::string> opt = {}) :
-		TokenizerBase(Keyword::L_Rust, s, opt) {}
+		TokenizerImpl(Keyword::L_Rust, s, opt) {}
 
 	~RustTokenizer();
 
 	friend class RustTokenizerTest;
 };
+extern template class TokenizerImpl<RustTokenizer>;
 #endif /* RUSTTOKENIZER_H */
@@ -0,0 +1,413 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "OutputSink.h"
+#include "Server.h"
+
+// Maximum amount of data sent in a single frame
+static const size_t MAX_FRAME_DATA = 1024 * 1024;
+
+// Size of a frame's type and length
+static const size_t FRAME_HEADER = 5;
+
+// Write the specified data to fd; return false on error
+static bool
+write_all(int fd, const char *data, size_t size)
+{
+	while (size) {
+		ssize_t n = write(fd, data, size);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n == -1)
+			return false;
+		data += n;
+		size -= n;
+	}
+	return true;
+}
+
+// Read the specified amount of data from fd; return false on EOF or error
+static bool
+read_all(int fd, char *data, size_t size)
+{
+	while (size) {
+		ssize_t n = read(fd, data, size);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		data += n;
+		size -= n;
+	}
+	return true;
+}
+
+// Encode the 32-bit value v as four little-endian bytes
+static void
+encode32(char *p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++, v >>= 8)
+		p[i] = static_cast<char>(v & 0xff);
+}
+
+static uint32_t
+decode32(const char *p)
+{
+	uint32_t v = 0;
+
+	for (int i = 3; i >= 0; i--)
+		v = (v << 8) | static_cast<unsigned char>(p[i]);
+	return v;
+}
+
+// Append to buf a frame of the specified type and data
+static void
+add_frame(std::string &buf, char type, std::string_view data)
+{
+	char header[FRAME_HEADER];
+
+	header[0] = type;
+	encode32(header + 1, data.size());
+	buf.append(header, sizeof(header));
+	buf.append(data);
+}
+
+// Append to buf the data as a series of frames of the specified type
+static void
+add_frames(std::string &buf, char type, std::string_view data)
+{
+	for (size_t i = 0; i < data.size(); i += MAX_FRAME_DATA)
+		add_frame(buf, type, data.substr(i, MAX_FRAME_DATA));
+}
+
+/*
+ * If buf contains a complete frame starting at pos, set its type
+ * and data, advance pos past it, and return true.
+ */
+static bool
+parse_frame(const std::string &buf, size_t &pos, char &type,
+		std::string_view &data)
+{
+	if (buf.size() - pos < FRAME_HEADER)
+		return false;
+	uint32_t n = decode32(buf.data() + pos + 1);
+	if (buf.size() - pos - FRAME_HEADER < n)
+		return false;
+	type = buf[pos];
+	data = std::string_view(buf.data() + pos + FRAME_HEADER, n);
+	pos += FRAME_HEADER + n;
+	return true;
+}
+
+/*
+ * Set addr to the address of the socket at the specified path.
+ * Return false, with errno set, if the path is too long.
+ */
+static bool
+socket_address(const std::string &path, struct sockaddr_un &addr)
+{
+	memset(&addr, 0, sizeof(addr));
+	if (path.size() >= sizeof(addr.sun_path)) {
+		errno = ENAMETOOLONG;
+		return false;
+	}
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path.c_str());
+	return true;
+}
+
+// The socket's path is kept absolute, as requests change the directory
+Server::Server(const std::string &socket_path) : path(socket_path),
+	listen_fd(-1), stop_fd{-1, -1}
+{
+	if (path.empty() || path[0] != '/') {
+		char *cwd = getcwd(nullptr, 0);
+		if (cwd) {
+			path = std::string(cwd) + '/' + path;
+			free(cwd);
+		}
+	}
+}
+
+Server::~Server()
+{
+	if (listen_fd != -1) {
+		close(listen_fd);
+		unlink(path.c_str());
+	}
+	for (int fd : stop_fd)
+		if (fd != -1)
+			close(fd);
+}
+
+bool
+Server::open(std::ostream &err)
+{
+	struct sockaddr_un addr;
+	auto *sa = reinterpret_cast<struct sockaddr *>(&addr);
+
+	if (!socket_address(path, addr) ||
+	    (listen_fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+		err << "Unable to create socket " << path << ": " <<
+			strerror(errno) << std::endl;
+		return false;
+	}
+
+	int r = bind(listen_fd, sa, sizeof(addr));
+	if (r == -1 && errno == EADDRINUSE) {
+		// Replace the socket, unless a server is listening on it
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		bool live = connect(fd, sa, sizeof(addr)) == 0;
+		close(fd);
+		if (live) {
+			err << "A server is already listening on " << path <<
+				std::endl;
+			close(listen_fd);
+			listen_fd = -1;
+			return false;
+		}
+		unlink(path.c_str());
+		r = bind(listen_fd, sa, sizeof(addr));
+	}
+	if (r == -1 || listen(listen_fd, SOMAXCONN) == -1 ||
+	    pipe(stop_fd) == -1) {
+		err << "Unable to listen on " << path << ": " <<
+			strerror(errno) << std::endl;
+		close(listen_fd);
+		listen_fd = -1;
+		return false;
+	}
+	return true;
+}
+
+void
+Server::stop()
+{
+	char c = 0;
+	(void)write(stop_fd[1], &c, 1);
+}
+
+/*
+ * Connections are non-blocking, and a request's response is queued
+ * and sent as the client accepts it, so that clients that don't read
+ * their output don't hold up the others.
+ * The following requests of a connection are only run after the
+ * response has been sent.
+ */
+void
+Server::run(const Handler &handler)
+{
+	// A client's connection and its partially received request
+	struct Connection {
+		int fd;
+		std::string in;		// Received data not yet processed
+		ServerRequest request;
+		std::string out;	// Response not yet sent
+		size_t nsent;		// Bytes of out already sent
+	};
+	std::vector<Connection> connections;
+
+	// Run the requests received on c; return false to close it
+	auto process = [&handler](Connection &c) {
+		size_t pos = 0;
+		char type;
+		std::string_view data;
+		while (c.out.empty() && parse_frame(c.in, pos, type, data)) {
+			switch (type) {
+			case 'D':
+				c.request.directory = data;
+				break;
+			case 'A':
+				c.request.args.emplace_back(data);
+				break;
+			case 'I':
+				c.request.input.append(data);
+				break;
+			case 'R':
+				{
+					OutputSink out;
+					std::ostringstream err;
+					char status[4];
+
+					encode32(status, handler(c.request, out,
+						err));
+					c.request = ServerRequest();
+					add_frames(c.out, 'O', out.str());
+					add_frames(c.out, 'E', err.str());
+					add_frame(c.out, 'X',
+						std::string_view(status, 4));
+					c.nsent = 0;
+				}
+				break;
+			default:
+				return false;
+			}
+		}
+		c.in.erase(0, pos);
+		return true;
+	};
+
+	// Read the data available on c; return false to close it
+	auto receive = [&process](Connection &c) {
+		char buf[64 * 1024];
+		ssize_t n = read(c.fd, buf, sizeof(buf));
+		if (n == 0 || (n == -1 && errno != EINTR && errno != EAGAIN))
+			return false;
+		if (n > 0)
+			c.in.append(buf, n);
+		return process(c);
+	};
+
+	// Send the response the client of c accepts; return false to close it
+	auto transmit = [&process](Connection &c) {
+		ssize_t n = write(c.fd, c.out.data() + c.nsent,
+			c.out.size() - c.nsent);
+		if (n == -1)
+			return errno == EINTR || errno == EAGAIN;
+		c.nsent += n;
+		if (c.nsent < c.out.size())
+			return true;
+		c.out.clear();
+		c.out.shrink_to_fit();
+		return process(c);
+	};
+
+	// Clients that disconnect while receiving output mustn't kill us
+	signal(SIGPIPE, SIG_IGN);
+
+	for (;;) {
+		std::vector<struct pollfd> fds;
+		fds.push_back({stop_fd[0], POLLIN, 0});
+		fds.push_back({listen_fd, POLLIN, 0});
+		for (auto &c : connections)
+			fds.push_back({c.fd,
+				static_cast<short>(c.out.empty() ? POLLIN :
+				POLLOUT), 0});
+
+		if (poll(fds.data(), fds.size(), -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (fds[0].revents)
+			break;
+
+		// Serve the existing connections, which start at fds[2]
+		size_t j = 0;
+		for (size_t i = 0; i < connections.size(); i++) {
+			Connection &c = connections[i];
+			short events = fds[i + 2].revents;
+			bool ok = true;
+			if (events & POLLOUT)
+				ok = transmit(c);
+			else if (events & POLLIN)
+				ok = receive(c);
+			else if (events)
+				ok = false;	// Error or hang-up
+			if (!ok)
+				close(c.fd);
+			else if (j++ != i)
+				connections[j - 1] = std::move(c);
+		}
+		connections.resize(j);
+
+		if (fds[1].revents & POLLIN) {
+			int fd = accept(listen_fd, nullptr, nullptr);
+			if (fd != -1) {
+				fcntl(fd, F_SETFL, O_NONBLOCK);
+				connections.push_back({fd, "", ServerRequest(),
+					"", 0});
+			}
+		}
+	}
+
+	for (auto &c : connections)
+		close(c.fd);
+}
+
+int
+Server::request(const std::string &socket_path, const ServerRequest &r,
+		OutputSink &out, std::ostream &err)
+{
+	struct sockaddr_un addr;
+	int fd = -1;
+
+	if (!socket_address(socket_path, addr) ||
+	    (fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1 ||
+	    connect(fd, reinterpret_cast<struct sockaddr *>(&addr),
+	    sizeof(addr)) == -1) {
+		err << "Unable to connect to " << socket_path << ": " <<
+			strerror(errno) << std::endl;
+		if (fd != -1)
+			close(fd);
+		return EXIT_FAILURE;
+	}
+
+	std::string frames;
+	add_frame(frames, 'D', r.directory);
+	for (auto &a : r.args)
+		add_frame(frames, 'A', a);
+	add_frames(frames, 'I', r.input);
+	add_frame(frames, 'R', "");
+	bool ok = write_all(fd, frames.data(), frames.size());
+
+	int status = EXIT_FAILURE;
+	bool done = false;
+	std::string data;
+	while (ok && !done) {
+		char header[FRAME_HEADER];
+		if (!read_all(fd, header, sizeof(header)))
+			break;
+		data.resize(decode32(header + 1));
+		if (!read_all(fd, &data[0], data.size()))
+			break;
+		switch (header[0]) {
+		case 'O':
+			out.write(data.data(), data.size());
+			break;
+		case 'E':
+			err << data;
+			break;
+		case 'X':
+			if (data.size() == 4)
+				status = decode32(data.data());
+			done = true;
+			break;
+		}
+	}
+	close(fd);
+
+	if (!done)
+		err << "The server at " << socket_path <<
+			" didn't complete the request" << std::endl;
+	return status;
+}
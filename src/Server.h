@@ -0,0 +1,87 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ * Serve tokenizer runs over a Unix domain socket.
+ *
+ * Requests and responses consist of frames, each containing
+ * a type character, the length of its data as a little-endian
+ * 32-bit value, and the data.
+ * A request consists of the client's working directory (D),
+ * its command-line arguments (A, one per argument),
+ * its standard input contents (I, zero or more), and a run frame (R).
+ * The response consists of output (O) and error message (E) frames,
+ * followed by the run's exit status (X) as a 32-bit value.
+ * A connection can carry any number of requests in succession.
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class OutputSink;
+
+// A request to run the tokenizer
+struct ServerRequest {
+	std::string directory;		// Client's working directory
+	std::vector<std::string> args;	// Command-line arguments
+	std::string input;		// Standard input contents
+};
+
+class Server {
+public:
+	// Run a request, outputting to out and err; return its exit status
+	typedef std::function<int(const ServerRequest &, OutputSink &,
+		std::ostream &)> Handler;
+private:
+	std::string path;	// Socket's absolute path
+	int listen_fd;		// Listening socket, or -1
+	int stop_fd[2];		// Pipe whose input stops the server
+public:
+	Server(const std::string &socket_path);
+	~Server();
+	Server(const Server &) = delete;
+	Server &operator=(const Server &) = delete;
+
+	/**
+	 * Start listening on the socket, replacing a stale socket file.
+	 * Return false, after reporting the error to err, if this isn't
+	 * possible, e.g. because another server is listening on it.
+	 */
+	bool open(std::ostream &err);
+
+	/**
+	 * Serve requests with the specified handler, one at a time,
+	 * until stop() is called.
+	 */
+	void run(const Handler &handler);
+
+	// Make run() return; can be called from another thread
+	void stop();
+
+	/**
+	 * Run the specified request on the server listening on the
+	 * specified socket, outputting its output to out and its error
+	 * messages to err.
+	 * Return the run's exit status, or EXIT_FAILURE, after reporting
+	 * the error to err, if the server can't be reached.
+	 */
+	static int request(const std::string &socket_path,
+		const ServerRequest &r, OutputSink &out, std::ostream &err);
+};
+#endif /* SERVER_H */
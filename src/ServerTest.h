@@ -0,0 +1,208 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef SERVERTEST_H
+#define SERVERTEST_H
+
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OutputSink.h"
+#include "Server.h"
+
+class ServerTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(ServerTest);
+	CPPUNIT_TEST(testRequest);
+	CPPUNIT_TEST(testLargeInput);
+	CPPUNIT_TEST(testStalledClient);
+	CPPUNIT_TEST(testLiveSocket);
+	CPPUNIT_TEST(testStaleSocket);
+	CPPUNIT_TEST(testNoServer);
+	CPPUNIT_TEST_SUITE_END();
+
+	std::string dir;
+	std::string socket_path;
+
+	// A server running in a thread, which is stopped when destroyed
+	class RunningServer {
+		Server &server;
+		std::thread thread;
+	public:
+		RunningServer(Server &s, const Server::Handler &h) : server(s),
+			thread([this, h] { server.run(h); }) {}
+		~RunningServer() {
+			server.stop();
+			thread.join();
+		}
+	};
+
+	// Output the request's fields, and exit with the number of arguments
+	static int echo(const ServerRequest &r, OutputSink &out,
+			std::ostream &err) {
+		out << r.directory << '|';
+		for (auto &a : r.args)
+			out << a << '|';
+		out << r.input;
+		err << "input size " << r.input.size();
+		return r.args.size();
+	}
+public:
+	void setUp() {
+		char name[] = "/tmp/ServerTestXXXXXX";
+		CPPUNIT_ASSERT(mkdtemp(name));
+		dir = name;
+		socket_path = dir + "/socket";
+	}
+
+	void tearDown() {
+		std::filesystem::remove_all(dir);
+	}
+
+	void testRequest() {
+		Server s(socket_path);
+		std::ostringstream open_err;
+		CPPUNIT_ASSERT(s.open(open_err));
+		RunningServer running(s, echo);
+
+		ServerRequest r{"/src", {"-l", "C", ""}, "int x;"};
+		OutputSink out;
+		std::ostringstream err;
+		CPPUNIT_ASSERT_EQUAL(3,
+			Server::request(socket_path, r, out, err));
+		CPPUNIT_ASSERT_EQUAL(std::string("/src|-l|C||int x;"),
+			out.str());
+		CPPUNIT_ASSERT_EQUAL(std::string("input size 6"), err.str());
+
+		// The server keeps serving requests
+		ServerRequest r2{"/", {}, ""};
+		OutputSink out2;
+		std::ostringstream err2;
+		CPPUNIT_ASSERT_EQUAL(0,
+			Server::request(socket_path, r2, out2, err2));
+		CPPUNIT_ASSERT_EQUAL(std::string("/|"), out2.str());
+	}
+
+	// Input and output spanning several frames
+	void testLargeInput() {
+		Server s(socket_path);
+		std::ostringstream open_err;
+		CPPUNIT_ASSERT(s.open(open_err));
+		RunningServer running(s, echo);
+
+		std::string input;
+		for (int i = 0; input.size() < 3 * 1024 * 1024; i++)
+			input += std::to_string(i) + '\n';
+		ServerRequest r{"/", {"a"}, input};
+		OutputSink out;
+		std::ostringstream err;
+		CPPUNIT_ASSERT_EQUAL(1,
+			Server::request(socket_path, r, out, err));
+		CPPUNIT_ASSERT(out.str() == "/|a|" + input);
+		CPPUNIT_ASSERT_EQUAL("input size " +
+			std::to_string(input.size()), err.str());
+	}
+
+	// A client that doesn't read its output doesn't block the others
+	void testStalledClient() {
+		Server s(socket_path);
+		std::ostringstream open_err;
+		CPPUNIT_ASSERT(s.open(open_err));
+		RunningServer running(s, echo);
+
+		struct sockaddr_un addr = {};
+		addr.sun_family = AF_UNIX;
+		strcpy(addr.sun_path, socket_path.c_str());
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		CPPUNIT_ASSERT(connect(fd,
+			reinterpret_cast<struct sockaddr *>(&addr),
+			sizeof(addr)) == 0);
+
+		// Request an output larger than the socket's buffer
+		std::string input(4 * 1024 * 1024, 'x');
+		std::string frames;
+		for (auto &f : {std::make_pair('D', std::string("/")),
+		    std::make_pair('I', input),
+		    std::make_pair('R', std::string())}) {
+			uint32_t n = f.second.size();
+			frames += f.first;
+			for (int i = 0; i < 4; i++, n >>= 8)
+				frames += static_cast<char>(n & 0xff);
+			frames += f.second;
+		}
+		CPPUNIT_ASSERT_EQUAL(static_cast<ssize_t>(frames.size()),
+			write(fd, frames.data(), frames.size()));
+
+		ServerRequest r{"/", {}, ""};
+		OutputSink out;
+		std::ostringstream err;
+		CPPUNIT_ASSERT_EQUAL(0,
+			Server::request(socket_path, r, out, err));
+		CPPUNIT_ASSERT_EQUAL(std::string("/|"), out.str());
+		close(fd);
+	}
+
+	void testLiveSocket() {
+		Server s(socket_path);
+		std::ostringstream err;
+		CPPUNIT_ASSERT(s.open(err));
+
+		Server s2(socket_path);
+		std::ostringstream err2;
+		CPPUNIT_ASSERT(!s2.open(err2));
+		CPPUNIT_ASSERT(err2.str().find("already listening") !=
+			std::string::npos);
+	}
+
+	// A socket left behind by a server that exited is replaced
+	void testStaleSocket() {
+		struct sockaddr_un addr = {};
+		addr.sun_family = AF_UNIX;
+		strcpy(addr.sun_path, socket_path.c_str());
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		CPPUNIT_ASSERT(bind(fd, reinterpret_cast<struct sockaddr *>(&addr),
+			sizeof(addr)) == 0);
+		close(fd);
+
+		Server s(socket_path);
+		std::ostringstream err;
+		CPPUNIT_ASSERT(s.open(err));
+		RunningServer running(s, echo);
+		ServerRequest r{"/", {}, ""};
+		OutputSink out;
+		CPPUNIT_ASSERT_EQUAL(0,
+			Server::request(socket_path, r, out, err));	}
+
+	void testNoServer() {
+		ServerRequest r{"/", {}, ""};
+		OutputSink out;
+		std::ostringstream err;
+		CPPUNIT_ASSERT_EQUAL(EXIT_FAILURE,
+			Server::request(socket_path, r, out, err));
+		CPPUNIT_ASSERT(err.str().find("Unable to connect") !=
+			std::string::npos);
+		CPPUNIT_ASSERT(out.str().empty());
+	}
+};
+#endif /* SERVERTEST_H */
@@ -0,0 +1,114 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef STRESSTEST_H
+#define STRESSTEST_H
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+#include <sys/resource.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CharSource.h"
+#include "TokenStream.h"
+#include "TokenizerBase.h"
+
+/*
+ * Tests that run over inputs too large for the unit tests;
+ * run them with "make stress".
+ */
+class StressTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(StressTest);
+	CPPUNIT_TEST(testLargeInput);
+	CPPUNIT_TEST_SUITE_END();
+
+	/*
+	 * A stream buffer returning the specified number of copies
+	 * of a text, generated as they are read, so that arbitrarily
+	 * large inputs can be streamed without storing them.
+	 */
+	class RepeatBuf : public std::streambuf {
+		static const size_t CHUNK_COPIES = 4096;
+		std::string chunk;	// Copies of the text returned at once
+		size_t text_size;	// Length of the text
+		uint64_t remain;	// Copies not yet returned
+	protected:
+		int_type underflow() override {
+			if (remain == 0)
+				return traits_type::eof();
+			uint64_t n = std::min<uint64_t>(remain, CHUNK_COPIES);
+			remain -= n;
+			setg(&chunk[0], &chunk[0], &chunk[0] + n * text_size);
+			return traits_type::to_int_type(chunk[0]);
+		}
+	public:
+		RepeatBuf(const std::string &text, uint64_t copies) :
+			text_size(text.size()), remain(copies) {
+			for (size_t i = 0; i < CHUNK_COPIES; i++)
+				chunk += text;
+		}
+	};
+
+	// Return the peak resident set size in kB
+	static long max_rss() {
+		struct rusage ru;
+		getrusage(RUSAGE_SELF, &ru);
+		return ru.ru_maxrss;
+	}
+public:
+	/*
+	 * Tokenize 5GB of C code, with more than 2^31 lines,
+	 * in bounded memory.
+	 */
+	void testLargeInput() {
+		// Eight tokens, the last one at column 11, on 31 lines
+		const std::string text = "f(a, 42); /* c */\n" +
+			std::string(30, '\n');
+		const uint64_t copies = (5ULL << 30) / text.size();
+		RepeatBuf buf(text, copies);
+		std::istream in(&buf);
+		CharSource src(in);
+		std::unique_ptr<TokenizerBase> t(TokenizerBase::new_tokenizer("C",
+			src, "stress"));
+		long rss = max_rss();
+
+		t->set_positions(true);
+		uint64_t ntokens = 0;
+		Position last{0, 0, 0};
+		while (t->get_token()) {
+			ntokens++;
+			last = t->get_position();
+		}
+
+		CPPUNIT_ASSERT_EQUAL(copies * 8, ntokens);
+		CPPUNIT_ASSERT_EQUAL(copies * text.size(), src.get_nchar());
+		CPPUNIT_ASSERT_EQUAL(copies * 31 + 1, src.line_number());
+		CPPUNIT_ASSERT(src.line_number() > (1ULL << 31));
+		CPPUNIT_ASSERT_EQUAL((copies - 1) * 31 + 1, last.line);
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(11), last.column);
+		CPPUNIT_ASSERT_EQUAL((copies - 1) * text.size() + 10,
+			last.offset);
+		// The input is streamed through a fixed-size buffer
+		CPPUNIT_ASSERT(max_rss() - rss < 64 * 1024);
+	}
+};
+#endif /* STRESSTEST_H */
@@ -14,35 +14,72 @@
  *   limitations under the License.
  */
 
-#include <map>
-#include <list>
+#include <cstring>
 #include <string>
 
 #include "SymbolTable.h"
 
 // Return a symbol's value, adding it if needed
 token_type
-SymbolTable::value(std::string symbol)
+SymbolTable::value(std::string_view symbol)
 {
-	Table::value_type &current_map = table.front();
-	Map::iterator lb = current_map.lower_bound(symbol);
-
-	// Look at current scope, keeping a hint for later insertion
-	if (lb != current_map.end() && lb->first == symbol)
-		return lb->second;
-
-	// Search from the second scope onward
-	auto i = table.begin();
-	for (i++; i != table.end(); i++) {
-		auto entry = i->find(symbol);
-		if (entry != i->end())
-			return entry->second;
+	if (2 * (entries.size() + 1) > slots.size())
+		grow();
+
+	uint32_t h = hash(symbol);
+	size_t mask = slots.size() - 1;
+	size_t i;
+
+	for (i = h & mask; slots[i]; i = (i + 1) & mask) {
+		const Entry &e = entries[slots[i] - 1];
+		if (e.hash == h && e.length == symbol.size() &&
+		    memcmp(names.data() + e.offset, symbol.data(),
+		    symbol.size()) == 0)
+			return e.value;
 	}
 
-	// Not found; insert it the the current scope
+	// Not found; insert it in the current scope
 	token_type val = next_symbol_value++;
-	current_map.insert(lb, Map::value_type(symbol, val));
+	entries.push_back(Entry{names.size(), symbol.size(), h, val});
+	names.append(symbol);
+	slots[i] = entries.size();
 	return val;
 }
 
+/*
+ * Remove the bindings entered in the current scope.
+ * These are the most recently added entries, so clearing their
+ * slots in reverse order leaves the probe sequences of the
+ * remaining entries intact.
+ */
+void
+SymbolTable::exit_scope()
+{
+	if (!scoping_enabled || scope_start.empty())
+		return;
+
+	size_t start = scope_start.back();
+	scope_start.pop_back();
+	while (entries.size() > start) {
+		slots[slot_of(entries.size() - 1)] = 0;
+		names.resize(entries.back().offset);
+		entries.pop_back();
+	}
+}
+
+// Double the hash table's size, adding the entries in their original order
+void
+SymbolTable::grow()
+{
+	slots.assign(2 * slots.size(), 0);
+
+	size_t mask = slots.size() - 1;
+	for (size_t n = 0; n < entries.size(); n++) {
+		size_t i = entries[n].hash & mask;
+		while (slots[i])
+			i = (i + 1) & mask;
+		slots[i] = n + 1;
+	}
+}
+
 bool SymbolTable::scoping_enabled = true;
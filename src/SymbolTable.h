@@ -17,48 +17,91 @@
 #ifndef SYMBOLTABLE_H
 #define SYMBOLTABLE_H
 
-#include <map>
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "TokenId.h"
 
 /**
  * Store and retrieve mappings from symbols to integers in a scoped
- * symbol table. Identifiers are entered in a map in the current scope
+ * symbol table. Identifiers are entered in the current scope
  * and retrieved from the first scope nearest to the current one in which
  * they appear.
+ * As a symbol is only entered when it isn't visible from the current
+ * scope, each symbol has at most one binding.  All bindings are kept
+ * in a single open-addressing hash table, and the bindings entered in
+ * a scope are removed on the scope's exit.
  */
 class SymbolTable {
+	// A symbol's binding; the symbol's name is interned in names
+	struct Entry {
+		size_t offset;		// Offset of the name in names
+		size_t length;		// Length of the name
+		uint32_t hash;		// Hash of the symbol's name
+		token_type value;	// Value associated with the symbol
+	};
 	token_type next_symbol_value;
-	typedef std::map<std::string, token_type> Map;	// Map at a single scope
-	typedef std::list <Map> Table;		// Table of all scopes
-	Table table;
+	/*
+	 * Entries in the order they were added, which also serves as
+	 * the log for undoing the bindings of exited scopes.
+	 */
+	std::vector<Entry> entries;
+	std::string names;		// Storage for the names of all entries
+	std::vector<size_t> slots;	// Hash table: entry index + 1, or 0
+	std::vector<size_t> scope_start;	// Number of entries at each scope
 	static bool scoping_enabled;
+
+	static uint32_t hash(std::string_view s) {
+		uint32_t h = 2166136261u;
+
+		for (unsigned char c : s)
+			h = (h ^ c) * 16777619u;
+		return h;
+	}
+
+	// Return the slot of the entry with the specified index
+	size_t slot_of(size_t index) const {
+		size_t mask = slots.size() - 1;
+		size_t i = entries[index].hash & mask;
+
+		while (slots[i] != index + 1)
+			i = (i + 1) & mask;
+		return i;
+	}
+
+	// Double the size of the hash table
+	void grow();
 public:
 	/** Construct an empty symbol table */
-	SymbolTable() : next_symbol_value(TokenId::FIRST_IDENTIFIER), table(1) {}
+	SymbolTable() : next_symbol_value(TokenId::FIRST_IDENTIFIER),
+		slots(64) {}
 
 	/** Return a symbol's value, adding it if needed */
-	token_type value(std::string symbol);
+	token_type value(std::string_view symbol);
 
 	void enter_scope() {
 		if (scoping_enabled)
-			table.push_front(Table::value_type());
+			scope_start.push_back(entries.size());
 	}
 
-	void exit_scope() {
-		if (scoping_enabled && table.size() > 1)
-			table.pop_front();
-	}
+	void exit_scope();
 
 	/** Return the current scope depth, with 0 being the outer scope */
 	int scope_depth() const {
-		return table.size() - 1;
+		return scope_start.size();
 	}
 
 	/** Disable scoping, forcing all identifiers in the same scope */
 	static void disable_scoping() {
 		scoping_enabled = false;
 	}
+
+	/** Enable scoping, which is the default */
+	static void enable_scoping() {
+		scoping_enabled = true;
+	}
 };
 #endif /* SYMBOLTABLE_H */
@@ -11,6 +11,8 @@ class SymbolTableTest : public CppUnit::TestFixture  {
 	CPPUNIT_TEST(testSingle);
 	CPPUNIT_TEST(testScope);
 	CPPUNIT_TEST(testScopeDepth);
+	CPPUNIT_TEST(testDeepScopes);
+	CPPUNIT_TEST(testMany);
 	CPPUNIT_TEST(testDisabledScope);
 	CPPUNIT_TEST_SUITE_END();
 public:
@@ -55,6 +57,46 @@ public:
 		CPPUNIT_ASSERT_EQUAL(0, s.scope_depth());
 	}
 
+	// Bindings of exited scopes are removed, at any depth
+	void testDeepScopes() {
+		SymbolTable s;
+
+		s.value("outer");
+		for (int i = 0; i < 100; i++) {
+			s.enter_scope();
+			CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + i + 1), s.value("v" + std::to_string(i)));
+		}
+		CPPUNIT_ASSERT_EQUAL(100, s.scope_depth());
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER), s.value("outer"));
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 1), s.value("v0"));
+		for (int i = 0; i < 99; i++)
+			s.exit_scope();
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 1), s.value("v0"));
+		// New value for a symbol of an exited scope
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 101), s.value("v1"));
+		s.exit_scope();
+		s.exit_scope();		// Ignored at the outer scope
+		CPPUNIT_ASSERT_EQUAL(0, s.scope_depth());
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER), s.value("outer"));
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 102), s.value("v0"));
+	}
+
+	// Symbols remain available as the table grows and shrinks
+	void testMany() {
+		SymbolTable s;
+
+		for (int i = 0; i < 1000; i++)
+			s.value("g" + std::to_string(i));
+		for (int round = 0; round < 3; round++) {
+			s.enter_scope();
+			for (int i = 0; i < 5000; i++)
+				s.value("l" + std::to_string(i));
+			for (int i = 0; i < 1000; i++)
+				CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + i), s.value("g" + std::to_string(i)));
+			s.exit_scope();
+		}
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 1000 + 3 * 5000), s.value("l0"));
+	}
 
 	void testDisabledScope() {
 		SymbolTable s;
@@ -73,6 +115,13 @@ public:
 		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER), s.value("foo"));
 		// Sane entry at outer scope
 		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 1), s.value("bar"));
+
+		SymbolTable::enable_scoping();
+		SymbolTable s2;
+		s2.enter_scope();
+		s2.value("foo");
+		s2.exit_scope();
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::FIRST_IDENTIFIER + 1), s2.value("foo"));
 	}
 };
 #endif /*  SYMBOLTABLETEST_H */
@@ -0,0 +1,220 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ContentHash.h"
+#include "OutputSink.h"
+#include "TokenCache.h"
+
+// Entries used within this time aren't touched again on each use
+static const time_t TOUCH_INTERVAL = 60 * 60;
+// Temporary files older than this were left behind by failed processes
+static const time_t STALE_TEMP_AGE = 60 * 60;
+
+std::unique_ptr<TokenCache>
+TokenCache::open(const std::string &dir, uint64_t max_size,
+		const std::string &options)
+{
+	if (mkdir(dir.c_str(), 0777) == -1 && errno != EEXIST)
+		return nullptr;
+	struct stat sb;
+	if (stat(dir.c_str(), &sb) == -1)
+		return nullptr;
+	if (!S_ISDIR(sb.st_mode)) {
+		errno = ENOTDIR;
+		return nullptr;
+	}
+	return std::unique_ptr<TokenCache>(new TokenCache(dir, max_size,
+		options));
+}
+
+/*
+ * Entries are stored in subdirectories named after the first
+ * two digits of their name, keeping the directories small.
+ */
+std::string
+TokenCache::entry(std::string_view contents) const
+{
+	static const char digits[] = "0123456789abcdef";
+	std::string name(ContentHash::hex(contents));
+
+	uint64_t h = ContentHash::xxh64(options, 0);
+	for (int i = 60; i >= 0; i -= 4)
+		name += digits[(h >> i) & 0xf];
+	return dir + '/' + name.substr(0, 2) + '/' + name.substr(2);
+}
+
+/*
+ * The header contains the options, which are verified to guard
+ * against hash collisions, followed by the output's size, which is
+ * verified to guard against entries truncated by a system crash.
+ */
+std::string
+TokenCache::header(const std::string &output_size) const
+{
+	return std::string("TOKC1\n") + options + '\0' + output_size + '\n';
+}
+
+bool
+TokenCache::get(const std::string &entry, OutputSink &out) const
+{
+	int fd = ::open(entry.c_str(), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat sb;
+	std::string data;
+	if (fstat(fd, &sb) == 0) {
+		data.resize(sb.st_size);
+		size_t n = 0;
+		while (n < data.size()) {
+			ssize_t r = read(fd, &data[n], data.size() - n);
+			if (r == -1 && errno == EINTR)
+				continue;
+			if (r <= 0)
+				break;
+			n += r;
+		}
+		data.resize(n);
+	}
+
+	// Mark the entry as recently used
+	if (!data.empty() && time(nullptr) - sb.st_mtime > TOUCH_INTERVAL)
+		(void)futimens(fd, nullptr);
+	close(fd);
+
+	std::string prefix(header(""));
+	prefix.pop_back();
+	if (data.compare(0, prefix.size(), prefix) != 0)
+		return false;
+	size_t eol = data.find('\n', prefix.size());
+	if (eol == std::string::npos)
+		return false;
+	std::string size(data, prefix.size(), eol - prefix.size());
+	if (size != std::to_string(data.size() - eol - 1))
+		return false;
+
+	out.write(data.data() + eol + 1, data.size() - eol - 1);
+	return true;
+}
+
+void
+TokenCache::put(const std::string &entry, std::string_view output)
+{
+	std::string data(header(std::to_string(output.size())));
+	data.append(output);
+	if (data.size() > max_size)
+		return;
+
+	std::string subdir(entry, 0, entry.rfind('/'));
+	if (mkdir(subdir.c_str(), 0777) == -1 && errno != EEXIST)
+		return;
+
+	std::string temp(dir + "/tmp." + std::to_string(getpid()) + '.' +
+		std::to_string(ntemp++));
+	int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+	if (fd == -1)
+		return;
+	size_t n = 0;
+	while (n < data.size()) {
+		ssize_t r = write(fd, data.data() + n, data.size() - n);
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r <= 0)
+			break;
+		n += r;
+	}
+	if (close(fd) == 0 && n == data.size() &&
+	    rename(temp.c_str(), entry.c_str()) == 0)
+		nstored += n;
+	else
+		unlink(temp.c_str());
+}
+
+void
+TokenCache::trim()
+{
+	if (nstored == 0)
+		return;
+
+	struct File {
+		time_t mtime;
+		uint64_t size;
+		std::string name;
+	};
+	std::vector<File> files;
+	uint64_t total = 0;
+	time_t now = time(nullptr);
+
+	DIR *top = opendir(dir.c_str());
+	if (!top)
+		return;
+	while (struct dirent *d = readdir(top)) {
+		std::string name(dir + '/' + d->d_name);
+		struct stat sb;
+
+		if (strncmp(d->d_name, "tmp.", 4) == 0) {
+			if (stat(name.c_str(), &sb) == 0 &&
+			    now - sb.st_mtime > STALE_TEMP_AGE)
+				unlink(name.c_str());
+			continue;
+		}
+		if (strlen(d->d_name) != 2 || d->d_name[0] == '.')
+			continue;
+		DIR *sub = opendir(name.c_str());
+		if (!sub)
+			continue;
+		while (struct dirent *e = readdir(sub)) {
+			if (e->d_name[0] == '.')
+				continue;
+			std::string path(name + '/' + e->d_name);
+			// Entries may be concurrently removed
+			if (stat(path.c_str(), &sb) == -1 ||
+			    !S_ISREG(sb.st_mode))
+				continue;
+			files.push_back({sb.st_mtime,
+				static_cast<uint64_t>(sb.st_size), path});
+			total += sb.st_size;
+		}
+		closedir(sub);
+	}
+	closedir(top);
+
+	if (total <= max_size)
+		return;
+
+	// Remove a tenth more, so that trimming isn't needed on every run
+	uint64_t target = max_size - max_size / 10;
+	std::sort(files.begin(), files.end(),
+		[](const File &a, const File &b) { return a.mtime < b.mtime; });
+	for (auto &f : files) {
+		if (total <= target)
+			break;
+		unlink(f.name.c_str());
+		total -= f.size;
+	}
+}
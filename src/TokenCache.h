@@ -0,0 +1,80 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef TOKENCACHE_H
+#define TOKENCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class OutputSink;
+
+/**
+ * A persistent cache of the tokenizer's output for each input,
+ * stored in a directory.
+ * Entries are named by the hash of the input's contents and of the
+ * options that affect the output, so they never become stale.
+ * The cache is kept under a size bound by removing its least recently
+ * used entries.
+ * Entries are written to temporary files, which are then renamed into
+ * place, so several processes and threads can use a cache concurrently.
+ * Failures to store entries are ignored; they only make the cache
+ * less effective.
+ */
+class TokenCache {
+	std::string dir;		// Directory holding the cache
+	uint64_t max_size;		// Maximum size of all entries
+	std::string options;		// Options that affect the output
+	std::atomic<uint64_t> nstored;	// Bytes stored by this process
+	std::atomic<unsigned> ntemp;	// Temporary files created
+
+	TokenCache(const std::string &d, uint64_t m, const std::string &o) :
+		dir(d), max_size(m), options(o), nstored(0), ntemp(0) {}
+
+	// Return the header preceding an output of the specified size
+	std::string header(const std::string &output_size) const;
+public:
+	/**
+	 * Return a cache stored in the specified directory, which is
+	 * created if needed, for output produced with the specified
+	 * options.
+	 * Return nullptr, with errno set, if the directory can't be created.
+	 */
+	static std::unique_ptr<TokenCache> open(const std::string &dir,
+		uint64_t max_size, const std::string &options);
+
+	// Return the name of the entry for the specified input contents
+	std::string entry(std::string_view contents) const;
+
+	/**
+	 * Append the output stored in the specified entry to out.
+	 * Return false if the entry isn't in the cache.
+	 */
+	bool get(const std::string &entry, OutputSink &out) const;
+
+	// Store the output of the specified entry
+	void put(const std::string &entry, std::string_view output);
+
+	/**
+	 * If entries were stored, remove the least recently used entries
+	 * until the cache fits its size bound.
+	 */
+	void trim();
+};
+#endif /* TOKENCACHE_H */
@@ -0,0 +1,150 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef TOKENCACHETEST_H
+#define TOKENCACHETEST_H
+
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OutputSink.h"
+#include "TokenCache.h"
+
+class TokenCacheTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(TokenCacheTest);
+	CPPUNIT_TEST(testGetPut);
+	CPPUNIT_TEST(testOptions);
+	CPPUNIT_TEST(testTruncated);
+	CPPUNIT_TEST(testTrim);
+	CPPUNIT_TEST(testOpenError);
+	CPPUNIT_TEST_SUITE_END();
+
+	std::string dir;
+
+	// Set the modification time of a file to the specified age
+	static void age(const std::string &name, time_t seconds) {
+		struct timespec t[2];
+		t[0].tv_sec = t[1].tv_sec = time(nullptr) - seconds;
+		t[0].tv_nsec = t[1].tv_nsec = 0;
+		utimensat(AT_FDCWD, name.c_str(), t, 0);
+	}
+public:
+	void setUp() {
+		char name[] = "/tmp/TokenCacheTestXXXXXX";
+		CPPUNIT_ASSERT(mkdtemp(name));
+		dir = name;
+	}
+
+	void tearDown() {
+		std::filesystem::remove_all(dir);
+	}
+
+	void testGetPut() {
+		auto c = TokenCache::open(dir + "/cache", 1 << 20, "C");
+		CPPUNIT_ASSERT(c);
+		std::string e(c->entry("int x;"));
+		OutputSink o;
+
+		CPPUNIT_ASSERT(!c->get(e, o));
+		c->put(e, std::string("1\t2\n\0", 5));
+		CPPUNIT_ASSERT(c->get(e, o));
+		CPPUNIT_ASSERT_EQUAL(std::string("1\t2\n\0", 5), o.str());
+		CPPUNIT_ASSERT(c->entry("int y;") != e);
+
+		// Entries persist across uses of the cache
+		auto c2 = TokenCache::open(dir + "/cache", 1 << 20, "C");
+		OutputSink o2;
+		CPPUNIT_ASSERT(c2->get(e, o2));
+		CPPUNIT_ASSERT_EQUAL(o.str(), o2.str());
+	}
+
+	// Output produced with different options is kept apart
+	void testOptions() {
+		auto c = TokenCache::open(dir, 1 << 20, "C -a");
+		auto c2 = TokenCache::open(dir, 1 << 20, "C -c");
+		OutputSink o;
+
+		c->put(c->entry("x"), "a");
+		CPPUNIT_ASSERT(c->entry("x") != c2->entry("x"));
+		CPPUNIT_ASSERT(!c2->get(c2->entry("x"), o));
+		// Even if the entry names collide
+		CPPUNIT_ASSERT(!c2->get(c->entry("x"), o));
+		CPPUNIT_ASSERT(o.str().empty());
+	}
+
+	// Entries truncated by a crash are ignored
+	void testTruncated() {
+		auto c = TokenCache::open(dir, 1 << 20, "C");
+		std::string e(c->entry("x"));
+		OutputSink o;
+
+		c->put(e, "12345");
+		CPPUNIT_ASSERT_EQUAL(0, truncate(e.c_str(),
+			std::filesystem::file_size(e) - 1));
+		CPPUNIT_ASSERT(!c->get(e, o));
+		CPPUNIT_ASSERT(o.str().empty());
+	}
+
+	// The least recently used entries are removed
+	void testTrim() {
+		auto c = TokenCache::open(dir, 200, "C");
+		std::string output(60, 'x');
+		std::string e1(c->entry("1")), e2(c->entry("2")),
+			e3(c->entry("3"));
+		OutputSink o;
+
+		c->trim();
+		c->put(e1, output);
+		c->put(e2, output);
+		c->put(e3, output);
+		age(e1, 3 * 3600);
+		age(e2, 1 * 3600);
+		age(e3, 2 * 3600);
+		std::ofstream(dir + "/tmp.1.0") << "stale";
+		age(dir + "/tmp.1.0", 2 * 3600);
+		// Using an entry marks it as recently used
+		CPPUNIT_ASSERT(c->get(e3, o));
+
+		c->trim();
+		CPPUNIT_ASSERT(!std::filesystem::exists(e1));
+		CPPUNIT_ASSERT(std::filesystem::exists(e3));
+		CPPUNIT_ASSERT(!std::filesystem::exists(dir + "/tmp.1.0"));
+
+		// Outputs larger than the cache aren't stored
+		std::string e4(c->entry("4"));
+		c->put(e4, std::string(300, 'x'));
+		CPPUNIT_ASSERT(!c->get(e4, o));
+	}
+
+	void testOpenError() {
+		std::ofstream(dir + "/file") << "x";
+		errno = 0;
+		CPPUNIT_ASSERT(!TokenCache::open(dir + "/file", 1, ""));
+		CPPUNIT_ASSERT_EQUAL(ENOTDIR, errno);
+		CPPUNIT_ASSERT(!TokenCache::open(dir + "/a/b", 1, ""));
+		CPPUNIT_ASSERT_EQUAL(ENOENT, errno);
+	}
+};
+#endif /* TOKENCACHETEST_H */
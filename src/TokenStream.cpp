@@ -0,0 +1,149 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "CharSource.h"
+#include "TokenizerBase.h"
+#include "TokenStream.h"
+
+TokenStream::TokenStream() : fd(-1), positions(false)
+{
+}
+
+bool
+TokenStream::open(const std::string &lang, const std::string &file_name,
+		bool all_contents)
+{
+	tokenizer.reset(TokenizerBase::new_tokenizer(lang, *src, file_name));
+	if (!tokenizer)
+		return false;
+	tokenizer->set_all_contents(all_contents);
+	return true;
+}
+
+std::unique_ptr<TokenStream>
+TokenStream::from_buffer(const std::string &lang, const char *data,
+		size_t size, bool all_contents)
+{
+	std::unique_ptr<TokenStream> ts(new TokenStream());
+
+	ts->src.reset(new CharSource(data, size));
+	if (!ts->open(lang, "(buffer)", all_contents))
+		return nullptr;
+	return ts;
+}
+
+std::unique_ptr<TokenStream>
+TokenStream::from_file(const std::string &lang, const std::string &file_name,
+		bool all_contents)
+{
+	std::unique_ptr<TokenStream> ts(new TokenStream());
+
+	ts->fd = ::open(file_name.c_str(), O_RDONLY);
+	if (ts->fd == -1)
+		return nullptr;
+	ts->src.reset(new CharSource(ts->fd));
+	if (!ts->open(lang, file_name, all_contents))
+		return nullptr;
+	return ts;
+}
+
+TokenStream::~TokenStream()
+{
+	// The tokenizer refers to the source, which refers to the file
+	tokenizer.reset();
+	src.reset();
+	if (fd != -1)
+		close(fd);
+}
+
+void
+TokenStream::set_error(std::ostream &e)
+{
+	tokenizer->set_error(e);
+}
+
+void
+TokenStream::set_positions(bool v)
+{
+	positions = v;
+	tokenizer->set_positions(v);
+}
+
+bool
+TokenStream::next(Record &r)
+{
+	// The characters and horizontal space runs, as text
+	static const struct Characters {
+		char c[TokenId::OTHER_TOKEN];
+		char space[TokenId::RLE_MAX];
+		char tab[TokenId::RLE_MAX];
+		Characters() {
+			for (token_type i = 0; i < TokenId::OTHER_TOKEN; i++)
+				c[i] = static_cast<char>(i);
+			std::fill(space, space + TokenId::RLE_MAX, ' ');
+			std::fill(tab, tab + TokenId::RLE_MAX, '\t');
+		}
+	} chars;
+
+	token_type t = tokenizer->get_token();
+	if (!t)
+		return false;
+
+	r.token = t;
+	if (positions) {
+		const Position &p = tokenizer->get_position();
+		r.line = p.line;
+		r.column = p.column;
+		r.offset = p.offset;
+	} else {
+		r.line = tokenizer->get_input_line_number();
+		r.column = 0;
+		r.offset = 0;
+	}
+	if (TokenId::is_character(t)) {
+		r.kind = TK_CHARACTER;
+		r.text = std::string_view(chars.c + t, 1);
+	} else if (TokenId::is_other_token(t)) {
+		r.kind = TK_OTHER;
+		r.text = tokenizer->token_to_symbol(t);
+	} else if (TokenId::is_keyword(t)) {
+		r.kind = TK_KEYWORD;
+		r.text = tokenizer->keyword_to_string(t);
+	} else if (TokenId::is_number(t)) {
+		r.kind = TK_NUMBER;
+		r.text = tokenizer->get_value();
+	} else if (TokenId::is_identifier(t)) {
+		r.kind = TK_IDENTIFIER;
+		r.text = tokenizer->get_value();
+	} else if (TokenId::is_horizontal_space(t)) {
+		r.kind = TK_SPACE;
+		if (t <= TokenId::RLE_SPACE + TokenId::RLE_MAX)
+			r.text = std::string_view(chars.space,
+				t - TokenId::RLE_SPACE);
+		else
+			r.text = std::string_view(chars.tab,
+				t - TokenId::RLE_TAB);
+	} else {
+		r.kind = TK_HASHED_CONTENT;
+		r.text = std::string_view();
+	}
+	return true;
+}
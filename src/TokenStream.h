@@ -0,0 +1,146 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TokenId.h"
+
+class CharSource;
+class TokenizerBase;
+
+/**
+ * The library interface of the tokenizer: a stream of the token
+ * records of a memory buffer or a file, obtained one at a time
+ * through next() or by iterating over the stream, e.g.
+ *
+ *	auto ts = TokenStream::from_file("C", "hello.c");
+ *	for (auto &r : *ts)
+ *		if (r.kind == TokenStream::TK_IDENTIFIER)
+ *			std::cout << r.text << '\n';
+ */
+class TokenStream {
+public:
+	enum Kind {
+		TK_CHARACTER,		// Single character (e.g. ';')
+		TK_OTHER,		// Other token (e.g. <<=, string literal)
+		TK_KEYWORD,		// The language's keyword
+		TK_NUMBER,		// Numeric literal
+		TK_IDENTIFIER,		// Identifier
+		TK_SPACE,		// Horizontal space; with all contents
+		TK_HASHED_CONTENT,	// Comment or string; with all contents
+	};
+
+	/**
+	 * A token record.
+	 * The text is that of identifiers and numbers, the symbol of other
+	 * tokens, and empty for hashed contents.  The text of identifiers
+	 * and numbers is only valid until the next record is obtained.
+	 * With positions set, the line, column, and byte offset are
+	 * those of the token's first character; otherwise the line
+	 * is the one at the token's end, and the column and offset are 0.
+	 */
+	struct Record {
+		token_type token;	// Token value, as in the numeric output
+		Kind kind;		// Token kind
+		std::string_view text;	// Token text
+		uint64_t line;		// Input line
+		uint64_t column;	// Byte column, starting at 1
+		uint64_t offset;	// Byte offset from the input's start
+	};
+
+	// An input iterator over the stream's records
+	class iterator {
+		TokenStream *ts;	// Stream being iterated, nullptr at its end
+		Record record;		// Current record
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Record;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Record *;
+		using reference = const Record &;
+
+		iterator(TokenStream *t = nullptr) : ts(t) {
+			if (ts)
+				++*this;
+		}
+		reference operator*() const { return record; }
+		pointer operator->() const { return &record; }
+		iterator &operator++() {
+			if (!ts->next(record))
+				ts = nullptr;
+			return *this;
+		}
+		bool operator==(const iterator &o) const { return ts == o.ts; }
+		bool operator!=(const iterator &o) const { return ts != o.ts; }
+	};
+
+	TokenStream(const TokenStream &) = delete;
+	TokenStream &operator=(const TokenStream &) = delete;
+	~TokenStream();
+
+	/**
+	 * Return a stream of the tokens of the specified language
+	 * in the specified memory buffer, which must remain valid while the
+	 * stream is used.
+	 * When all_contents is set, also return the whitespace and
+	 * the hashes of comments and strings.
+	 * Return nullptr if the language isn't supported.
+	 */
+	static std::unique_ptr<TokenStream> from_buffer(const std::string &lang,
+		const char *data, size_t size, bool all_contents = false);
+
+	/**
+	 * Return a stream of the tokens of the specified language
+	 * in the named file.
+	 * Return nullptr, with errno set if the file couldn't be opened,
+	 * on error.
+	 */
+	static std::unique_ptr<TokenStream> from_file(const std::string &lang,
+		const std::string &file_name, bool all_contents = false);
+
+	// Set the stream of the tokenizer's error messages
+	void set_error(std::ostream &e);
+
+	// Find the position of each token; call before obtaining records
+	void set_positions(bool v);
+
+	// Set r to the next record; return false at the end of the input
+	bool next(Record &r);
+
+	iterator begin() { return iterator(this); }
+	iterator end() { return iterator(); }
+private:
+	int fd;					// Open file, or -1
+	bool positions;				// True to find positions
+	std::unique_ptr<CharSource> src;	// Source of the characters
+	std::unique_ptr<TokenizerBase> tokenizer;
+
+	TokenStream();
+	// Create the tokenizer; return false if the language isn't supported
+	bool open(const std::string &lang, const std::string &file_name,
+		bool all_contents);
+};
+#endif /* TOKENSTREAM_H */
@@ -0,0 +1,153 @@
+#ifndef TOKENSTREAMTEST_H
+#define TOKENSTREAMTEST_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "TokenStream.h"
+
+class TokenStreamTest : public CppUnit::TestFixture  {
+	CPPUNIT_TEST_SUITE(TokenStreamTest);
+	CPPUNIT_TEST(testBuffer);
+	CPPUNIT_TEST(testIterator);
+	CPPUNIT_TEST(testAllContents);
+	CPPUNIT_TEST(testFile);
+	CPPUNIT_TEST(testErrors);
+	CPPUNIT_TEST(testPositions);
+	CPPUNIT_TEST_SUITE_END();
+
+	// Return the records of a stream as kind:text@line strings
+	static std::vector<std::string> records(TokenStream &ts) {
+		std::vector<std::string> v;
+
+		for (auto &r : ts) {
+			std::ostringstream s;
+			s << r.kind << ':' << r.text << '@' << r.line;
+			v.push_back(s.str());
+		}
+		return v;
+	}
+public:
+	void testBuffer() {
+		const char code[] = "int x = 0x10;\ny++;";
+		auto ts = TokenStream::from_buffer("C", code, sizeof(code) - 1);
+		TokenStream::Record r;
+
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT_EQUAL(TokenStream::TK_KEYWORD, r.kind);
+		CPPUNIT_ASSERT_EQUAL(std::string("int"), std::string(r.text));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), r.line);
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT_EQUAL(TokenStream::TK_IDENTIFIER, r.kind);
+		CPPUNIT_ASSERT_EQUAL(std::string("x"), std::string(r.text));
+		CPPUNIT_ASSERT(r.text.data() == code + 4);
+		token_type x = r.token;
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT_EQUAL(TokenStream::TK_CHARACTER, r.kind);
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>('='), r.token);
+		CPPUNIT_ASSERT_EQUAL(std::string("="), std::string(r.text));
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT_EQUAL(TokenStream::TK_NUMBER, r.kind);
+		CPPUNIT_ASSERT_EQUAL(std::string("0x10"), std::string(r.text));
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT_EQUAL(TokenStream::TK_IDENTIFIER, r.kind);
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), r.line);
+		CPPUNIT_ASSERT(r.token != x);
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT_EQUAL(TokenStream::TK_OTHER, r.kind);
+		CPPUNIT_ASSERT_EQUAL(std::string("++"), std::string(r.text));
+		CPPUNIT_ASSERT(ts->next(r));
+		CPPUNIT_ASSERT(!ts->next(r));
+	}
+
+	void testIterator() {
+		const char code[] = "def f(a):\n  return a";
+		auto ts = TokenStream::from_buffer("Python", code,
+			sizeof(code) - 1);
+		std::vector<std::string> expect = {
+			"2:def@1", "4:f@1", "0:(@1", "4:a@1", "0:)@1", "0::@1",
+			"2:return@2", "4:a@2",
+		};
+
+		CPPUNIT_ASSERT(records(*ts) == expect);
+		CPPUNIT_ASSERT(ts->begin() == ts->end());
+	}
+
+	void testAllContents() {
+		const char code[] = "a  /* c */ b";
+		auto ts = TokenStream::from_buffer("C", code, sizeof(code) - 1,
+			true);
+		std::vector<std::string> r(records(*ts));
+
+		CPPUNIT_ASSERT(r.size() > 3);
+		CPPUNIT_ASSERT_EQUAL(std::string("4:a@1"), r[0]);
+		CPPUNIT_ASSERT_EQUAL(std::string("5:  @1"), r[1]);
+		CPPUNIT_ASSERT_EQUAL(std::string("4:b@1"), r.back());
+		bool hashed = false;
+		for (auto &s : r)
+			if (s == "6:@1")
+				hashed = true;
+		CPPUNIT_ASSERT(hashed);
+	}
+
+	void testFile() {
+		char name[] = "/tmp/TokenStreamTestXXXXXX";
+		int fd = mkstemp(name);
+		CPPUNIT_ASSERT(fd != -1);
+		const char code[] = "package main\n";
+		CPPUNIT_ASSERT(write(fd, code, sizeof(code) - 1) ==
+			sizeof(code) - 1);
+		close(fd);
+
+		auto ts = TokenStream::from_file("Go", name);
+		std::vector<std::string> expect = {"2:package@1", "4:main@1"};
+		std::vector<std::string> r(records(*ts));
+		unlink(name);
+		CPPUNIT_ASSERT(r == expect);
+	}
+
+	void testErrors() {
+		CPPUNIT_ASSERT(!TokenStream::from_buffer("COBOL", "", 0));
+
+		errno = 0;
+		CPPUNIT_ASSERT(!TokenStream::from_file("C",
+			"/nonexistent/file.c"));
+		CPPUNIT_ASSERT_EQUAL(ENOENT, errno);
+
+		const char code[] = "\"abc";
+		auto ts = TokenStream::from_buffer("C", code, sizeof(code) - 1);
+		std::ostringstream err;
+		ts->set_error(err);
+		CPPUNIT_ASSERT(records(*ts).empty());
+		CPPUNIT_ASSERT(err.str().find("EOF") != std::string::npos);
+	}
+
+	void testPositions() {
+		const char code[] = "int\n  /* c\n */ x =\t1;";
+		auto ts = TokenStream::from_buffer("C", code, sizeof(code) - 1);
+		std::vector<std::string> v;
+
+		ts->set_positions(true);
+		for (auto &r : *ts) {
+			std::ostringstream s;
+			s << r.text << '@' << r.line << ':' << r.column << '+' <<
+				r.offset;
+			v.push_back(s.str());
+		}
+		std::vector<std::string> expect = {
+			"int@1:1+0", "/*...*/@2:3+6", "x@3:5+15", "=@3:7+17", "1@3:9+19", ";@3:10+20",
+		};
+		CPPUNIT_ASSERT(v == expect);
+	}
+};
+#endif /* TOKENSTREAMTEST_H */
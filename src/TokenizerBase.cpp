@@ -16,15 +16,26 @@
 
 #include <cctype>
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <cfloat>
 #include <cmath>
 #include <sstream>
 
 #include "BolState.h"
 #include "CharSource.h"
+#include "CTokenizer.h"
+#include "CppTokenizer.h"
+#include "CSharpTokenizer.h"
+#include "GoTokenizer.h"
+#include "JavaTokenizer.h"
+#include "JavaScriptTokenizer.h"
+#include "PHPTokenizer.h"
+#include "PythonTokenizer.h"
+#include "RustTokenizer.h"
 #include "TokenizerBase.h"
 #include "Token.h"
 #include "TokenId.h"
@@ -49,12 +60,14 @@ TokenizerBase::compress(double d)
  * Convert the passed number into an integer token value, in the range
  * NUMBER_ZERO +- 500, with 0 being NUMBER_ZERO and the rest being
  * represented through base 10 logarithms.
+ * This is the reference implementation of num_token(), used for
+ * the values that it cannot classify exactly.
  */
 token_type
-TokenizerBase::num_token(const std::string &val)
+TokenizerBase::strtod_num_token(const char *val)
 {
 
-	double d = strtod(val.c_str(), NULL);
+	double d = strtod(val, NULL);
 
 	switch (std::fpclassify(d)) {
 	case FP_INFINITE: return TokenId::NUMBER_INFINITE;
@@ -66,7 +79,197 @@ TokenizerBase::num_token(const std::string &val)
 	return compress(d);
 }
 
+// Return true if c is a decimal digit; isdigit() is a library call
+static inline bool
+is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// Return the value of the hexadecimal digit c, or -1 if it isn't one
+static inline int
+hex_digit_value(char c)
+{
+	if (is_digit(c))
+		return c - '0';
+	c |= 0x20;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+// Return 10^k, for k in [0, 19]
+static inline uint64_t
+power_of_ten(int k)
+{
+	static const uint64_t p[] = {
+		1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull,
+		1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+		10000000000ull, 100000000000ull, 1000000000000ull,
+		10000000000000ull, 100000000000000ull,
+		1000000000000000ull, 10000000000000000ull,
+		100000000000000000ull, 1000000000000000000ull,
+		10000000000000000000ull,
+	};
+	return p[k];
+}
+
+// Return the token of 10^k, for k in [-MAX_EXPONENT, MAX_EXPONENT]
+token_type
+TokenizerBase::power_of_ten_token(int k)
+{
+	struct Table {
+		token_type token[2 * MAX_EXPONENT + 1];
+		Table() {
+			for (int i = -MAX_EXPONENT; i <= MAX_EXPONENT; i++) {
+				std::string s("1e" + std::to_string(i));
+				token[i + MAX_EXPONENT] = strtod_num_token(s.c_str());
+			}
+		}
+	};
+	static const Table t;
+
+	return t.token[k + MAX_EXPONENT];
+}
+
+/*
+ * Return the token of the decimal number val, as strtod() and compress()
+ * would, by counting its digits.
+ * The value is represented as 0.d1d2d3... * 10^exponent, and only its
+ * leading significant digits are examined to establish that it
+ * isn't a power of ten, or so close to one that rounding errors in the
+ * logarithm's calculation would affect the result.
+ */
+token_type
+TokenizerBase::decimal_num_token(const char *val)
+{
+	const char *p = val;
+	int ndigits = 0;		// All digits
+	int nsignificant = 0;		// Significant digits
+	bool seen_point = false;
+	bool one = true;		// Significant digits are 10...
+	bool nines = true;		// Significant digits are 99...
+	bool tail = false;		// Non-zero digits after NEAR_DIGITS
+	int exponent = 0;
+
+	for (;; p++) {
+		if (is_digit(*p)) {
+			ndigits++;
+			if (nsignificant == 0) {
+				if (*p == '0') {
+					// Leading zero
+					if (seen_point)
+						exponent--;
+					continue;
+				}
+				one = (*p == '1');
+			} else if (nsignificant < NEAR_DIGITS) {
+				if (*p != '0')
+					one = false;
+			} else if (*p != '0')
+				tail = true;
+			if (nsignificant < NEAR_DIGITS && *p != '9')
+				nines = false;
+			nsignificant++;
+			if (!seen_point)
+				exponent++;
+		} else if (*p == '.' && !seen_point)
+			seen_point = true;
+		else
+			break;
+	}
+	if (ndigits == 0)
+		return strtod_num_token(val);
+
+	// Exponent, if followed by digits
+	if (*p == 'e' || *p == 'E') {
+		const char *e = p + 1;
+		int sign = 1;
+		if (*e == '+' || *e == '-')
+			sign = *e++ == '-' ? -1 : 1;
+		int n = 0;
+		for (; is_digit(*e); e++)
+			if (n < 100000)
+				n = n * 10 + *e - '0';
+		exponent += sign * n;
+	}
+
+	if (nsignificant == 0)
+		return TokenId::NUMBER_ZERO;
+	// Avoid values near the double's range
+	if (exponent > MAX_EXPONENT || exponent <= -MAX_EXPONENT)
+		return strtod_num_token(val);
+	if (one)
+		return tail ? strtod_num_token(val) :
+			power_of_ten_token(exponent - 1);
+	if (nines && nsignificant >= NEAR_DIGITS)
+		return strtod_num_token(val);
+
+	// The base 10 logarithm is between exponent - 1 and exponent
+	if (exponent > 0)
+		return TokenId::NUMBER_ZERO + exponent + 1;
+	else
+		return TokenId::NUMBER_ZERO + exponent - 1;
+}
+
+/*
+ * Convert the passed number into an integer token value, in the range
+ * NUMBER_ZERO +- 500, with 0 being NUMBER_ZERO and the rest being
+ * represented through base 10 logarithms.
+ * Hexadecimal integers are converted into decimal ones; as with strtod()
+ * other bases, such as octal and binary, are converted as decimal
+ * numbers or as zero.
+ */
+token_type
+TokenizerBase::num_token(std::string_view val)
+{
+	// The scanners below need a NUL-terminated string
+	char buff[64];
+	std::string copy;
+	const char *s;
+	if (val.size() < sizeof(buff)) {
+		memcpy(buff, val.data(), val.size());
+		buff[val.size()] = 0;
+		s = buff;
+	} else {
+		copy = val;
+		s = copy.c_str();
+	}
+
+	if (s[0] != '0' || (s[1] != 'x' && s[1] != 'X'))
+		return decimal_num_token(s);
+
+	// Hexadecimal integers that can be exactly represented as a double
+	uint64_t v = 0;
+	const char *p;
+	int d;
+	for (p = s + 2; (d = hex_digit_value(*p)) >= 0; p++) {
+		if (v >> 49)
+			return strtod_num_token(s);
+		v = v * 16 + d;
+	}
+	// Hexadecimal floating point
+	if (*p == '.' || *p == 'p' || *p == 'P')
+		return strtod_num_token(s);
+	if (v == 0)
+		return TokenId::NUMBER_ZERO;
+
+	// Count v's decimal digits (at most 16), and classify as above
+	static const uint64_t near = power_of_ten(NEAR_DIGITS - 1);
+	int ndigits = 1;
+	while (v >= power_of_ten(ndigits))
+		ndigits++;
+	uint64_t low = power_of_ten(ndigits - 1);
+	if (v == low)
+		return power_of_ten_token(ndigits - 1);
+	if (ndigits >= NEAR_DIGITS && (v - low < low / near ||
+	    power_of_ten(ndigits) - v <= power_of_ten(ndigits) / near / 10))
+		return strtod_num_token(s);
+	return TokenId::NUMBER_ZERO + ndigits + 1;
+}
+
 // Process a block comment, returning the token's code
+template <bool AllContents>
 token_type
 TokenizerBase::get_block_comment_token()
 {
@@ -75,7 +278,7 @@ TokenizerBase::get_block_comment_token()
 
 	src.get(c1);
 
-	if (all_contents) {
+	if constexpr (AllContents) {
 		sequence_hash.reset();
 		sequence_hash.add(c1);
 	}
@@ -88,11 +291,15 @@ TokenizerBase::get_block_comment_token()
 		while (c1 != '*') {
 			if (!isspace(c1) && bol.at_bol_space())
 				bol.saw_non_space();
+			// Nothing before the next * can change the state
+			if constexpr (!AllContents)
+				if (!bol.at_bol_space())
+					src.skip_to('*', '*');
 			if (!src.get(c1)) {
 				error("EOF encountered while processing a block comment");
 				return 0;
 			}
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c1);
 		}
 		if (!isspace(c1) && bol.at_bol_space())
@@ -103,15 +310,16 @@ TokenizerBase::get_block_comment_token()
 		}
 		if (c1 == '/')
 			break;
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c1);
 	}
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 	return ret;
 }
 
 // Process a line comment, returning the token type
+template <bool AllContents>
 token_type
 TokenizerBase::get_line_comment_token()
 {
@@ -120,7 +328,7 @@ TokenizerBase::get_line_comment_token()
 
 	src.get(c1);
 
-	if (all_contents) {
+	if constexpr (AllContents) {
 		sequence_hash.reset();
 		sequence_hash.add(c1);
 	}
@@ -131,29 +339,32 @@ TokenizerBase::get_line_comment_token()
 	for (;;) {
 		if (c1 == '\n')
 			break;
+		if constexpr (!AllContents)
+			src.skip_to('\n', '\n');
 		if (!src.get(c1)) {
-			if (all_contents)
+			if constexpr (AllContents)
 				push_token(sequence_hash.get());
 			return ret;
 		}
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c1);
 	}
 	src.push(c1);
 
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 
 	return ret;
 }
 
 // Process a character literal, returning false on EOF
+template <bool AllContents>
 bool
 TokenizerBase::process_char_literal()
 {
 	char c0;	// Each character read
 
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	for (;;) {
 		if (!src.get(c0)) {
@@ -164,73 +375,94 @@ TokenizerBase::process_char_literal()
 			// Consume one character after the backslash
 			// ... to deal with the '\'' problem
 			src.get(c0);
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 			continue;
 		}
 		if (c0 == '\'')
 			break;
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c0);
 	}
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 	return true;
 }
 
 // Process a string literal, returning false on EOF
+template <bool AllContents>
 bool
 TokenizerBase::process_string_literal()
 {
 	char c0;
 
 	bol.saw_non_space();
-	if (all_contents)
+	if constexpr (AllContents)
 		sequence_hash.reset();
 	for (;;) {
+		if constexpr (!AllContents)
+			src.skip_to('"', '\\');
 		if (!src.get(c0)) {
 			error("EOF encountered while processing a string literal");
 			return false;
 		}
-		if (all_contents)
+		if constexpr (AllContents)
 			sequence_hash.add(c0);
 		if (c0 == '\\') {
 			// Consume one character after the backslash
 			src.get(c0);
-			if (all_contents)
+			if constexpr (AllContents)
 				sequence_hash.add(c0);
 			continue;
 		} else if (c0 == '"')
 			break;
 	}
-	if (all_contents)
+	if constexpr (AllContents)
 		push_token(sequence_hash.get());
 	return true;
 }
 
-// Process a number starting with the passed string returning its token value
+// Variants for the code-only and the all contents lexers
+template token_type TokenizerBase::get_block_comment_token<false>();
+template token_type TokenizerBase::get_block_comment_token<true>();
+template token_type TokenizerBase::get_line_comment_token<false>();
+template token_type TokenizerBase::get_line_comment_token<true>();
+template bool TokenizerBase::process_char_literal<false>();
+template bool TokenizerBase::process_char_literal<true>();
+template bool TokenizerBase::process_string_literal<false>();
+template bool TokenizerBase::process_string_literal<true>();
+
+// Process a number starting with c0 returning its token value
 token_type
-TokenizerBase::get_number_token(std::string &val)
+TokenizerBase::get_number_token(char c0)
 {
-	char c0;
+	// Letters, digits, decimal and digit separators
+	value = src.view_word(c0, number_chars);
+	if (!value.empty()) {
+		if ((value.back() != 'e' && value.back() != 'E') ||
+		    (src.peek() != '+' && src.peek() != '-'))
+			return num_token(value);
+		// Continue with the exponent sign in val
+		val = value;
+	} else
+		val = c0;
 
 	for (;;) {
-		src.get(c0);
-		if (c0 == 'e' || c0 == 'E') {
-			val += c0;
-			src.get(c0);
-			if (c0 == '+' || c0 == '-') {
-				val += c0;
-				continue;
-			}
-		}
-		// Decimal and digit separators
-		if (!isalnum(c0) && c0 != '.' && c0 != '_' && c0 != '\'')
+		// Letters, digits, decimal and digit separators
+		src.get_word(val, number_chars);
+		if (val.back() != 'e' && val.back() != 'E')
+			break;
+		// Exponent sign
+		if (!src.get(c0))
 			break;
+		if (c0 != '+' && c0 != '-') {
+			src.push(c0);
+			break;
+		}
 		val += c0;
 	}
-	src.push(c0);
-	return num_token(val);
+	value = val;
+	return num_token(value);
 }
 
 // Synchronize the input line number with the output line
@@ -238,224 +470,45 @@ void
 TokenizerBase::lines_synchronize()
 {
 	while (src.line_number() > output_line_number) {
-		std::cout << std::endl;
+		*out << '\n';
 		output_line_number++;
 	}
 }
 
 /*
- * Output numeric token values.
- * If compress is true, all identifiers, numbers, and types have the same value.
+ * Compress the value of token c, so that all identifiers, numbers,
+ * and types have the same value.
+ * Return false if the token should be ignored, because it is part of
+ * a series of type tokens.
  */
-void
-TokenizerBase::numeric_tokenize(bool compress)
-{
-	token_type c;
-
-	previously_in_method = false;
-	while ((c = get_token())) {
-
-		if (compress) {
-			// Merge together a series of type tokens
-			if (keyword.is_type(c)) {
-				token_type c2 = get_token();
-				push_token(c2);
-				if (keyword.is_type(c2))
-					continue; // Ignore c
-			}
-
-			if (TokenId::is_identifier(c))
-				c = TokenId::ANY_IDENTIFIER;
-			else if (keyword.is_type(c))
-				c = TokenId::ANY_TYPE;
-			else if (TokenId::is_number(c))
-				c = TokenId::ANY_NUMBER;
-			else if (TokenId::is_hashed_content(c))
-				c = TokenId::ANY_HASH;
-		}
-
-		switch (processing_type) {
-		case PT_LINE:
-			lines_synchronize();
-			// FALLTHROUGH
-		case PT_FILE:
-			std::cout << c << separator;
-			break;
-		case PT_METHOD:
-			if (previously_in_method && !nesting.in_method())
-				std::cout << c << std::endl;
-			if (nesting.in_method())
-				std::cout << c << separator;
-			break;
-		case PT_STATEMENT:
-			if (previously_in_method && !nesting.in_method())
-				std::cout << c << std::endl;
-			if (nesting.in_method()) {
-				if (c == ';')
-					std::cout << c << std::endl;
-				else
-					std::cout << c << separator;
-			}
-			break;
-		}
-		previously_in_method = nesting.in_method();
-	}
-
-	std::cout << std::endl;
-}
-
-void
-TokenizerBase::type_tokenize()
-{
-	token_type c;
-
-	previously_in_method = false;
-	while ((c = get_token())) {
-		std::ostringstream os;
-
-		if (TokenId::is_character(c))
-			os << (char)c;
-		else if (TokenId::is_keyword(c))
-			os.str(keyword_to_string(c));
-		else if (TokenId::is_other_token(c))
-			os.str(token_to_string(c));
-		else if (TokenId::is_zero(c) || TokenId::is_number(c))
-			os << "NUM";
-		else if (TokenId::is_identifier(c))
-			os << "ID";
-		else if (TokenId::is_hashed_content(c))
-			os << "HASH";
-		else
-			assert(false);
-
-		delimit(os.str(), c);
-	}
-
-	std::cout << std::endl;
-}
-
-
-/*
- * Output a token c named s preceded or followed by any
- * required delimiters.
- */
-void
-TokenizerBase::delimit(const std::string &s, token_type c)
-{
-	switch (processing_type) {
-	case PT_LINE:
-		lines_synchronize();
-		// FALLTHROUGH
-	case PT_FILE:
-		std::cout << s << separator;
-		break;
-	case PT_METHOD:
-		if (previously_in_method && !nesting.in_method())
-			std::cout << s << std::endl;
-		if (nesting.in_method())
-			std::cout << s << separator;
-		break;
-	case PT_STATEMENT:
-		if (previously_in_method && !nesting.in_method())
-			std::cout << s << std::endl;
-		if (nesting.in_method()) {
-			if (c == ';')
-				std::cout << s << std::endl;
-			else
-				std::cout << s << separator;
-		}
-		break;
-	}
-	previously_in_method = nesting.in_method();
-}
-
-void
-TokenizerBase::symbolic_tokenize()
+bool
+TokenizerBase::compress_token(token_type &c)
 {
-	token_type c;
-
-	previously_in_method = false;
-	while ((c = get_token())) {
-		std::ostringstream os;
-
-		if (TokenId::is_character(c))
-			os << (char)c;
-		else if (TokenId::is_keyword(c))
-			os.str(keyword_to_string(c));
-		else if (TokenId::is_other_token(c))
-			os.str(token_to_string(c));
-		else if (TokenId::is_zero(c))
-			os.str("0");
-		else if (TokenId::is_number(c))
-			os << "~1E" << c - TokenId::NUMBER_ZERO;
-		else if (TokenId::is_identifier(c))
-			os << "ID:" << c;
-		else if (TokenId::is_hashed_content(c))
-			os << "HASH:" << c;
-		else
-			assert(false);
-
-		delimit(os.str(), c);
+	// Merge together a series of type tokens
+	if (keyword.is_type(c)) {
+		token_type c2 = get_token();
+		push_token(c2);
+		if (keyword.is_type(c2))
+			return false; // Ignore c
 	}
 
-	std::cout << std::endl;
-}
-
-void
-TokenizerBase::code_tokenize()
-{
-	token_type c;
-
-	while ((c = get_token())) {
-		if (TokenId::is_character(c) && !isspace((unsigned char)c))
-			std::cout << (char)c;
-		else if (TokenId::is_keyword(c))
-			std::cout <<keyword_to_string(c);
-		else if (TokenId::is_other_token(c))
-			std::cout << token_to_symbol(c);
-		else if (TokenId::is_zero(c))
-			std::cout << "0";
-		else if (TokenId::is_number(c))
-			std::cout << get_value();
-		else if (TokenId::is_identifier(c))
-			std::cout << get_value();
-		else if (TokenId::is_hashed_content(c))
-			std::cout << get_value();
-		else
-			assert(false);
-		std::cout << std::endl;
-	}
+	if (TokenId::is_identifier(c))
+		c = TokenId::ANY_IDENTIFIER;
+	else if (keyword.is_type(c))
+		c = TokenId::ANY_TYPE;
+	else if (TokenId::is_number(c))
+		c = TokenId::ANY_NUMBER;
+	else if (TokenId::is_hashed_content(c))
+		c = TokenId::ANY_HASH;
+	return true;
 }
 
-void
-TokenizerBase::type_code_tokenize()
+// Return the processing type specified by the options
+enum TokenizerBase::ProcessingType
+TokenizerBase::processing_option(const std::vector<std::string> &opt)
 {
-	token_type c;
-
-	while ((c = get_token())) {
-		if (TokenId::is_character(c) && !isspace((unsigned char)c))
-			std::cout << "TOK " << (char)c;
-		else if (TokenId::is_keyword(c))
-			std::cout << "KW " << keyword_to_string(c);
-		else if (TokenId::is_other_token(c))
-			std::cout << "TOK " << token_to_symbol(c);
-		else if (TokenId::is_zero(c))
-			std::cout << "NUM 0";
-		else if (TokenId::is_number(c))
-			std::cout << "NUM " << get_value();
-		else if (TokenId::is_identifier(c))
-			std::cout << "ID " << get_value();
-		else if (TokenId::is_hashed_content(c))
-			std::cout << "HASH " << get_value();
-		else
-			assert(false);
-		std::cout << std::endl;
-	}
-}
+	enum ProcessingType processing_type = PT_FILE;
 
-void
-TokenizerBase::process_options(std::vector<std::string> opt)
-{
 	for (auto &o : opt) {
 		if (o == "file")
 			processing_type = PT_FILE;
@@ -472,14 +525,21 @@ TokenizerBase::process_options(std::vector<std::string> opt)
 			exit(EXIT_FAILURE);
 		}
 	}
+	return processing_type;
 }
 
 // Return a single token from the queue or the lexical stream
 token_type
 TokenizerBase::get_token()
 {
-	if (token_queue.empty())
-		return get_immediate_token();
+	if (token_queue.empty()) {
+		if (!track_positions)
+			return get_immediate_token();
+		positions.before_token();
+		token_type t = get_immediate_token();
+		position = positions.token_position(all_contents);
+		return t;
+	}
 
 	token_type token = token_queue.back();
 	token_queue.pop_back();
@@ -489,3 +549,35 @@ TokenizerBase::get_token()
 TokenizerBase::~TokenizerBase()
 {
 }
+
+TokenizerBase *
+TokenizerBase::new_tokenizer(const std::string &lang, CharSource &cs,
+		const std::string &filename, const std::vector<std::string> &opt)
+{
+	TokenizerBase *t;
+
+	if (lang == "C")
+		t = new CTokenizer(cs, filename, opt);
+	else if (lang == "CSharp" || lang == "C#")
+		t = new CSharpTokenizer(cs, filename, opt);
+	else if (lang == "Go")
+		t = new GoTokenizer(cs, filename, opt);
+	else if (lang == "Java")
+		t = new JavaTokenizer(cs, filename, opt);
+	else if (lang == "JavaScript")
+		t = new JavaScriptTokenizer(cs, filename, opt);
+	else if (lang == "C++")
+		t = new CppTokenizer(cs, filename, opt);
+	else if (lang == "PHP")
+		t = new PHPTokenizer(cs, filename, opt);
+	else if (lang == "Python")
+		t = new PythonTokenizer(cs, filename, opt);
+	else if (lang == "Rust")
+		t = new RustTokenizer(cs, filename, opt);
+	else if (lang == "TypeScript")
+		t = new JavaScriptTokenizer(cs, filename, opt,
+				Keyword::L_TypeScript);
+	else
+		t = nullptr;
+	return t;
+}
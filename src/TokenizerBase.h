@@ -17,28 +17,38 @@
 #ifndef TOKENIZERBASE_H
 #define TOKENIZERBASE_H
 
+#include <cassert>
 #include <deque>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "BinaryWriter.h"
 #include "BolState.h"
 #include "CharSource.h"
+#include "CloneDetector.h"
 #include "SymbolTable.h"
 #include "IncrementalHash.h"
 #include "Keyword.h"
+#include "MinHash.h"
 #include "NestedClassState.h"
+#include "NgramCounter.h"
+#include "Operator.h"
+#include "OutputSink.h"
+#include "PositionTracker.h"
 #include "RunLengthEncoder.h"
 
 /** Split input into language-specific tokens */
 class TokenizerBase {
-private:
+protected:
 	bool previously_in_method;
+	std::deque <token_type> token_queue;
 
-	void delimit(const std::string &s, token_type c);
+	bool compress_token(token_type &c);
 
-	std::deque <token_type> token_queue;
-protected:
 	// Language's keywords, initialized in subclass
 	Keyword keyword;
 
@@ -46,31 +56,119 @@ protected:
 	bool all_contents;
 
 	std::stringstream string_src;	// Source for testing
-	CharSource src;			// Character source
+	CharSource string_cs;		// Character source for testing
+	CharSource &src;		// Character source
 	RunLengthEncoder rle;		// RLE horizontal space
-	int output_line_number;		// Current line number in output
+	PositionTracker positions;	// Finds the tokens' positions
+	Position position;		// Position of the last lexed token
+	bool track_positions;		// True to find the positions
+	uint64_t output_line_number;	// Current line number in output
 	/** True for keywords that don't end with semicolon */
 	bool saw_comment;		// True after a comment
 	BolState bol;			// Beginning of line state
 	std::string input_file;		// Input file name
-	std::string val;		// Token value (ids, strings, nums, ...)
+	/*
+	 * Token value (ids, nums, ...), viewed in the input buffer
+	 * when possible, or else in val
+	 */
+	std::string_view value;
+	std::string val;		// Storage for values copied from the input
+	OutputSink *out;		// Destination of the tokenized output
+	std::ostream *err;		// Destination of error messages
+	/*
+	 * Number of leading significant digits num_token() examines to
+	 * rule out values that are powers of ten or very close to them.
+	 */
+	static const int NEAR_DIGITS = 12;
+	// Largest decimal exponent that num_token() handles without strtod()
+	static const int MAX_EXPONENT = 300;
+	static token_type power_of_ten_token(int k);
+	static token_type decimal_num_token(const char *val);
+
+	/*
+	 * Set the token value to c0, just read, followed by the
+	 * run of word characters w
+	 */
+	void get_word_value(char c0, const ByteScan::WordChars &w) {
+		value = src.view_word(c0, w);
+		if (value.empty()) {
+			val = c0;
+			src.get_word(val, w);
+			value = val;
+		}
+	}
+
 	// Report an error message
 	void error(const std::string &msg) {
-		std::cerr << input_file << '(' << src.line_number() << "): " <<
+		*err << input_file << '(' << src.line_number() << "): " <<
 			msg << std::endl;
 	}
+public:
 	enum ProcessingType {
 		PT_FILE,		// Output vector for whole class
 		PT_LINE,		// Output vector for each line
 		PT_METHOD,		// Output vector for each method
 		PT_STATEMENT,		// Output vector for each statement
-	} processing_type;
+	};
+
+	// Return the processing type specified by the options
+	static enum ProcessingType processing_option(
+			const std::vector<std::string> &opt);
 
-	void process_options(std::vector<std::string> opt);
+	/**
+	 * Return a new tokenizer for the specified language and character
+	 * source, or nullptr if the language is not supported.
+	 */
+	static TokenizerBase *new_tokenizer(const std::string &lang,
+		CharSource &cs, const std::string &file_name,
+		const std::vector<std::string> &opt = {});
+protected:
+	enum ProcessingType processing_type;
+
+	void process_options(std::vector<std::string> opt) {
+		processing_type = processing_option(opt);
+	}
 
 	enum ProcessingType get_processing_type() const {
 		return processing_type;
 	}
+
+	// Call f with the processing type as a compile-time constant
+	template <typename F>
+	void with_processing_type(F f) {
+		switch (processing_type) {
+		case PT_FILE:
+			f(std::integral_constant<ProcessingType, PT_FILE>());
+			break;
+		case PT_LINE:
+			f(std::integral_constant<ProcessingType, PT_LINE>());
+			break;
+		case PT_METHOD:
+			f(std::integral_constant<ProcessingType, PT_METHOD>());
+			break;
+		case PT_STATEMENT:
+			f(std::integral_constant<ProcessingType, PT_STATEMENT>());
+			break;
+		}
+	}
+
+	// Call f with the all contents setting as a compile-time constant
+	template <typename F>
+	void with_all_contents(F f) {
+		if (all_contents)
+			f(std::true_type());
+		else
+			f(std::false_type());
+	}
+
+	// Call f with the position tracking setting as a compile-time constant
+	template <typename F>
+	void with_positions(F f) {
+		if (track_positions)
+			f(std::true_type());
+		else
+			f(std::false_type());
+	}
 	SymbolTable symbols;
 	NestedClassState nesting;
 	char separator;			// Output token separator
@@ -79,6 +177,10 @@ protected:
 	virtual token_type get_immediate_token() = 0;
 
 	IncrementalHash sequence_hash;
+
+	// Characters of identifiers and numbers; languages can override them
+	static constexpr ByteScan::WordChars identifier_chars{'_'};
+	static constexpr ByteScan::WordChars number_chars{'.', '_', '\''};
 public:
 	/*
 	 * Compress the passed number into its base 10 logarithm
@@ -98,17 +200,42 @@ public:
 
 	void lines_synchronize();	// Synchronize input/output newlines
 
-	// Tokenize numbers to stdout
-	void numeric_tokenize(bool compress);
+	/*
+	 * The following output methods are implemented for each language
+	 * in TokenizerImpl.
+	 */
+	// Tokenize numbers to the output
+	virtual void numeric_tokenize(bool compress) = 0;
+
+	virtual void symbolic_tokenize() = 0;	// Tokenize symbols to the output
+	virtual void code_tokenize() = 0;	// Tokenize code to the output
+	virtual void type_tokenize() = 0;	// Tokenize token types to the output
+	// Tokenize token code and its type to the output
+	virtual void type_code_tokenize() = 0;
 
-	void symbolic_tokenize();	// Tokenize symbols to stdout
-	void code_tokenize();		// Tokenize code to stdout
-	void type_tokenize();		// Tokenize token types to stdout
-	void type_code_tokenize();	// Tokenize token code and its type to stdoit
-	int get_output_line_number() const { return output_line_number; }
+	// Tokenize numbers in binary form to the output
+	virtual void binary_tokenize(BinaryWriter &writer, bool compress) = 0;
+	// Count the n-grams of the tokens in each unit with counter
+	virtual void ngram_tokenize(NgramCounter &counter, bool compress) = 0;
+	// Add the units of tokens to units, for detecting clones
+	virtual void clone_tokenize(CloneDetector::FileUnits &units,
+		bool compress) = 0;
+	// Compute the MinHash signature of each unit of tokens with m
+	virtual void minhash_tokenize(MinHash &m, bool compress) = 0;
+	uint64_t get_output_line_number() const { return output_line_number; }
+	uint64_t get_input_line_number() { return src.line_number(); }
 
 	void set_separator(char s) { separator = s; }
+	void set_output(OutputSink &o) { out = &o; }
+	void set_error(std::ostream &e) { err = &e; }
 	void set_all_contents(bool v) { all_contents = v; }
+	/**
+	 * Find the position of each token, for the output of the
+	 * -b, -B, and binary formats, and for get_position()
+	 */
+	void set_positions(bool v) { track_positions = v; }
+	// Return the position of the last token lexed with positions set
+	const Position &get_position() const { return position; }
 
 	// Construct from a character source
 	TokenizerBase(Keyword::LanguageId lid,
@@ -116,8 +243,12 @@ public:
 			std::vector<std::string> opt = {}) :
 		keyword(lid),
 		all_contents(false),
-		src(s), rle(s), output_line_number(1), saw_comment(false),
-		input_file(file_name), processing_type(PT_FILE) {
+		src(s), rle(src), positions(src), position{1, 1, 0},
+		track_positions(false), output_line_number(1),
+		saw_comment(false),
+		input_file(file_name), out(&OutputSink::standard_output()),
+		err(&std::cerr),
+		processing_type(PT_FILE) {
 		process_options(opt);
 	}
 
@@ -127,21 +258,60 @@ public:
 			std::vector<std::string> opt = {}) :
 		keyword(lid),
 		all_contents(false),
-		string_src(s), src(string_src), rle(src),
+		string_src(s), string_cs(string_src), src(string_cs), rle(src),
+		positions(src), position{1, 1, 0}, track_positions(false),
 		output_line_number(1),
 		saw_comment(false), input_file("(string)"),
+		out(&OutputSink::standard_output()), err(&std::cerr),
 		processing_type(PT_FILE) {
 		process_options(opt);
 	}
 
-	~TokenizerBase();
+	virtual ~TokenizerBase();
+
+	static token_type num_token(std::string_view val);
+	// As num_token(), but through strtod() and compress()
+	static token_type strtod_num_token(const char *val);
+	/*
+	 * The following are instantiated for the code-only lexers and,
+	 * with AllContents set, for those that also hash the contents.
+	 */
+	template <bool AllContents> token_type get_block_comment_token();
+	template <bool AllContents> token_type get_line_comment_token();
+	template <bool AllContents> bool process_char_literal();
+	template <bool AllContents> bool process_string_literal();
+	token_type get_number_token(char c0);
 
-	static token_type num_token(const std::string &val);
-	token_type get_block_comment_token();
-	token_type get_line_comment_token();
-	bool process_char_literal();
-	bool process_string_literal();
-	token_type get_number_token(std::string &val);
-	const std::string & get_value() const { return val; }
+	/*
+	 * Return the longest operator of the table t that starts with c0,
+	 * which must itself be one of its operators.
+	 * Characters are only pushed back when the input matches a prefix
+	 * that isn't an operator (e.g. .. in C).
+	 */
+	token_type get_operator_token(char c0, const Operator::Table &t) {
+		int state = t.next[t.char_class[c0 & 0x7f]];
+		int accepted = state;	// Last state reached with an operator
+		char unaccepted[Operator::MAX_LENGTH];	// Characters read after it
+		int nunaccepted = 0;
+
+		assert(t.accept[state]);
+		for (;;) {
+			char c = src.peek();
+			int next = t.next[state * t.nclasses + t.char_class[c & 0x7f]];
+			if (!next)
+				break;
+			src.get(c);
+			state = next;
+			if (t.accept[state]) {
+				accepted = state;
+				nunaccepted = 0;
+			} else
+				unaccepted[nunaccepted++] = c;
+		}
+		while (nunaccepted)
+			src.push(unaccepted[--nunaccepted]);
+		return t.accept[accepted];
+	}
+	std::string_view get_value() const { return value; }
 };
 #endif /* TOKENIZERBASE_H */
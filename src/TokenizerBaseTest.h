@@ -1,12 +1,16 @@
 #ifndef TOKENIZERBASETEST_H
 #define TOKENIZERBASETEST_H
 
+#include <cstdint>
+#include <cstdio>
 #include <sstream>
+#include <string>
 
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "CharSource.h"
 #include "CTokenizer.h"
+#include "OutputSink.h"
 #include "Token.h"
 #include "Keyword.h"
 
@@ -21,7 +25,10 @@ class TokenizerBaseTest : public CppUnit::TestFixture  {
 	CPPUNIT_TEST(testComment);
 	CPPUNIT_TEST(testHashBlockComment);
 	CPPUNIT_TEST(testHashLineComment);
+	CPPUNIT_TEST(testContentLines);
 	CPPUNIT_TEST(testNumber);
+	CPPUNIT_TEST(testNumTokenExhaustive);
+	CPPUNIT_TEST(testValueView);
 	CPPUNIT_TEST(testOutputLineNumber);
 	CPPUNIT_TEST_SUITE_END();
 public:
@@ -153,6 +160,21 @@ public:
 		CPPUNIT_ASSERT_EQUAL(t1, t3);
 	}
 
+	// Lines skipped within comments and strings are counted
+	void testContentLines() {
+		CTokenizer ct("a /* x\n * y\n */ b\n\"s\\\n\\\"t\" // c \" *\n"
+			"d /**/ e /***/\n\n  /* z */ f\n", {"line"});
+		OutputSink o;
+		ct.set_output(o);
+		ct.set_separator(' ');
+		ct.symbolic_tokenize();
+		CPPUNIT_ASSERT_EQUAL(std::string("ID:2000 \n\n"
+			"BLOCK_COMMENT ID:2001 \n\n"
+			"STRING_LITERAL LINE_COMMENT \n"
+			"ID:2002 BLOCK_COMMENT ID:2003 BLOCK_DOC_COMMENT \n\n"
+			"BLOCK_COMMENT ID:2004 \n"), o.str());
+	}
+
 	void testNumber() {
 		CTokenizer ct("0");
 		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::NUMBER_ZERO), ct.get_token());
@@ -198,11 +220,119 @@ public:
 
 		CTokenizer ct9("1e400");
 		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::NUMBER_INFINITE), ct9.get_token());
+
+		CTokenizer ct10("1e+2x;");
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::NUMBER_ZERO + 3), ct10.get_token());
+		CPPUNIT_ASSERT_EQUAL(std::string("1e+2x"), std::string(ct10.get_value()));
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(';'), ct10.get_token());
+
+		CTokenizer ct11("1'000e-");
+		ct11.get_token();
+		CPPUNIT_ASSERT_EQUAL(std::string("1'000e-"), std::string(ct11.get_value()));
+	}
+
+	// Values are viewed in an in-memory input, rather than copied
+	void testValueView() {
+		const char data[] = "foo 0x1f 1e+2x bar";
+		CharSource cs(data, sizeof(data) - 1);
+		CTokenizer t(cs, "view");
+
+		CPPUNIT_ASSERT(TokenId::is_identifier(t.get_token()));
+		CPPUNIT_ASSERT_EQUAL(std::string("foo"), std::string(t.get_value()));
+		CPPUNIT_ASSERT(t.get_value().data() == data);
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::NUMBER_ZERO + 3), t.get_token());
+		CPPUNIT_ASSERT_EQUAL(std::string("0x1f"), std::string(t.get_value()));
+		CPPUNIT_ASSERT(t.get_value().data() == data + 4);
+		// The exponent's sign is copied
+		CPPUNIT_ASSERT_EQUAL(static_cast<token_type>(TokenId::NUMBER_ZERO + 3), t.get_token());
+		CPPUNIT_ASSERT_EQUAL(std::string("1e+2x"), std::string(t.get_value()));
+		CPPUNIT_ASSERT(TokenId::is_identifier(t.get_token()));
+		CPPUNIT_ASSERT_EQUAL(std::string("bar"), std::string(t.get_value()));
+		CPPUNIT_ASSERT(t.get_value().data() == data + 15);
+	}
+
+	// Verify num_token() against strtod() for the value s
+	static void check_num_token(const std::string &s) {
+		token_type expected = TokenizerBase::strtod_num_token(s.c_str());
+		token_type actual = TokenizerBase::num_token(s);
+		// Report the value on failure
+		if (expected != actual)
+			CPPUNIT_ASSERT_EQUAL(s + " " + std::to_string(expected),
+				s + " " + std::to_string(actual));
+	}
+
+	void testNumTokenExhaustive() {
+		char buff[64];
+
+		// Integers, in decimal and in hexadecimal
+		for (unsigned i = 0; i < 1000000; i++) {
+			check_num_token(std::to_string(i));
+			snprintf(buff, sizeof(buff), "0x%x", i);
+			check_num_token(buff);
+		}
+
+		// Values around all powers of ten and of two
+		uint64_t p10 = 1;
+		for (int i = 0; i < 20; i++, p10 *= 10)
+			for (uint64_t d = 0; d < 1000; d++) {
+				check_num_token(std::to_string(p10 + d));
+				check_num_token(std::to_string(p10 - d));
+				snprintf(buff, sizeof(buff), "0X%llX",
+					(unsigned long long)(p10 - d));
+				check_num_token(buff);
+			}
+		for (int i = 0; i < 64; i++)
+			for (int d = -2; d <= 2; d++) {
+				snprintf(buff, sizeof(buff), "0x%llx",
+					(1ull << i) + d);
+				check_num_token(buff);
+			}
+
+		// Mantissas near powers of ten with all exponents
+		for (auto m : {"1", "1.0", "10", "0.01", "2", "9", "99", "5.5",
+				"999999999999", "9999999999999", "99999999999.9",
+				"1000000000001", "100000000000000001",
+				"1.00000000001", "1.000000000001", "0.999999999999",
+				"123456789012345678901234567890", "0000", "00.0"})
+			for (int e = -340; e <= 340; e++) {
+				snprintf(buff, sizeof(buff), "%se%d", m, e);
+				check_num_token(buff);
+			}
+
+		// Other bases and literal forms
+		for (auto s : {"017", "0b101", "0B1", "0o17", "1_000", "1'000",
+				"1e", "1e+", "1e-x", "1.e5", ".5", "1.", "0.",
+				"00012.50e+0002", "1.5.3", "1e5e3", "0x", "0xg",
+				"0x1.8p3", "0x1p-2", "0x.8", "0x1fULL", "1.5f",
+				"123L", "1e0000000000000000005", "1e99999999999",
+				"0x1_F", "0xFFFFFFFFFFFFFFFFFFFF"})
+			check_num_token(s);
+
+		// Random digit sequences with points and exponents
+		uint32_t r = 1;
+		for (int i = 0; i < 300000; i++) {
+			std::string s;
+			int len = 1 + (r = r * 1103515245 + 12345) % 24;
+			for (int j = 0; j < len; j++) {
+				r = r * 1103515245 + 12345;
+				switch ((r >> 16) % 16) {
+				case 0: s += '.'; break;
+				case 1: s += 'e'; break;
+				case 2: s += '-'; break;
+				case 3: case 4: s += '9'; break;
+				case 5: case 6: s += '0'; break;
+				default: s += '0' + (r >> 8) % 10; break;
+				}
+			}
+			if (isdigit(s[0]) || (s[0] == '.' && isdigit(s[1])))
+				check_num_token(s);
+		}
 	}
 
 	void testOutputLineNumber() {
 		CTokenizer ct("0");
-		CPPUNIT_ASSERT_EQUAL(1, ct.get_output_line_number());
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1),
+			ct.get_output_line_number());
 	}
 };
 #endif /*  TOKENIZERBASETEST_H */
@@ -0,0 +1,151 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef TOKENIZERBENCH_H
+#define TOKENIZERBENCH_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "Benchmark.h"
+#include "CharSource.h"
+#include "OutputSink.h"
+#include "CTokenizer.h"
+#include "CppTokenizer.h"
+#include "CSharpTokenizer.h"
+#include "GoTokenizer.h"
+#include "JavaTokenizer.h"
+#include "JavaScriptTokenizer.h"
+#include "PHPTokenizer.h"
+#include "PythonTokenizer.h"
+#include "RustTokenizer.h"
+
+class TokenizerBench {
+	static inline volatile int processing_type = 1;	// Line
+
+	// Output v with per-token dispatch on the processing type
+	template <typename V>
+	static void delimit(TokenizerBase &t, OutputSink &out, const V &v) {
+		switch (processing_type) {
+		case 1:
+			t.lines_synchronize();
+			// FALLTHROUGH
+		case 0:
+			out << v << '\t';
+			break;
+		default:
+			out << v << '\n';
+			break;
+		}
+	}
+
+	/*
+	 * The numeric and symbolic output loops with per-token dispatch,
+	 * as used before the loops were specialized: a virtual call for
+	 * each token, a processing type test, and (for symbolic output)
+	 * a string stream.
+	 */
+	static size_t dispatched_loop(TokenizerBase &t, OutputSink &out,
+			bool symbolic) {
+		token_type c;
+
+		while ((c = t.get_token())) {
+			if (!symbolic) {
+				delimit(t, out, c);
+				continue;
+			}
+
+			std::ostringstream os;
+			if (TokenId::is_character(c))
+				os << (char)c;
+			else if (TokenId::is_keyword(c))
+				os.str(t.keyword_to_string(c));
+			else if (TokenId::is_other_token(c))
+				os.str(t.token_to_string(c));
+			else if (TokenId::is_zero(c))
+				os.str("0");
+			else if (TokenId::is_number(c))
+				os << "~1E" << c - TokenId::NUMBER_ZERO;
+			else if (TokenId::is_identifier(c))
+				os << "ID:" << c;
+			else
+				os << "HASH:" << c;
+			delimit(t, out, os.str());
+		}
+		out << '\n';
+		return out.str().size();
+	}
+
+	// Compare the two loops for tokenizer T on the specified code
+	template <typename T>
+	static void compare(const std::string &name, const std::string &code) {
+		size_t ntokens = 0;
+		{
+			CharSource cs(code.data(), code.size());
+			T t(cs, "bench", {"line"});
+			while (t.get_token())
+				ntokens++;
+		}
+
+		for (bool symbolic : {false, true}) {
+			std::string mode(symbolic ? " symbolic" : " numeric");
+			double before = Benchmark::run(name + mode +
+				" dispatched", ntokens, "token",
+				[&code, symbolic]() {
+					CharSource cs(code.data(), code.size());
+					T t(cs, "bench", {"line"});
+					OutputSink out;
+					t.set_output(out);
+					return dispatched_loop(t, out, symbolic);
+				});
+			double after = Benchmark::run(name + mode +
+				" specialized", ntokens, "token",
+				[&code, symbolic]() {
+					CharSource cs(code.data(), code.size());
+					T t(cs, "bench", {"line"});
+					OutputSink out;
+					t.set_output(out);
+					if (symbolic)
+						t.symbolic_tokenize();
+					else
+						t.numeric_tokenize(false);
+					return out.str().size();
+				});
+			Benchmark::speedup(before, after);
+			std::cout << std::left << std::setw(48) <<
+				"  throughput" << std::right <<
+				std::setw(10) << std::fixed <<
+				std::setprecision(1) << 1e3 / after <<
+				" Mtokens/s" << std::endl;
+		}
+	}
+public:
+	static void run() {
+		std::string code(Benchmark::source_code(8 * 1024 * 1024));
+
+		compare<CTokenizer>("C tokenizer", code);
+		compare<CppTokenizer>("C++ tokenizer", code);
+		compare<CSharpTokenizer>("C# tokenizer", code);
+		compare<GoTokenizer>("Go tokenizer", code);
+		compare<JavaTokenizer>("Java tokenizer", code);
+		compare<JavaScriptTokenizer>("JavaScript tokenizer", code);
+		compare<PHPTokenizer>("PHP tokenizer", "<?php\n" + code);
+		compare<PythonTokenizer>("Python tokenizer", code);
+		compare<RustTokenizer>("Rust tokenizer", code);
+	}
+};
+#endif /* TOKENIZERBENCH_H */
@@ -0,0 +1,440 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef TOKENIZERIMPL_H
+#define TOKENIZERIMPL_H
+
+#include <cassert>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "BinaryWriter.h"
+#include "CloneDetector.h"
+#include "NgramCounter.h"
+#include "TokenizerBase.h"
+
+/**
+ * The output loops of a language's tokenizer, statically bound to
+ * the language's lexer, the derived class Derived.
+ * Each loop is instantiated for the code-only and the all contents
+ * lexer variants, every processing type and, where relevant,
+ * compression setting, so that no per-token dispatch remains.
+ * The public tokenize methods select the instantiation once for
+ * each file.
+ * Each derived class explicitly instantiates its implementation
+ * in its source file, where its lexer can be inlined into the loops.
+ */
+template <typename Derived>
+class TokenizerImpl : public TokenizerBase {
+	Derived &derived() { return *static_cast<Derived *>(this); }
+
+	/*
+	 * Return a single token from the queue or the language's lexer.
+	 * With Positions set, also find the position of lexed tokens;
+	 * queued tokens share the position of the token lexed with them.
+	 */
+	template <bool AllContents, bool Positions = false>
+	token_type next_token() {
+		if (token_queue.empty()) {
+			if constexpr (Positions) {
+				positions.before_token();
+				token_type t = derived().Derived::template
+					lex_token<AllContents>();
+				position = positions.token_position(AllContents);
+				return t;
+			} else
+				return derived().Derived::template
+					lex_token<AllContents>();
+		}
+
+		token_type token = token_queue.back();
+		token_queue.pop_back();
+		return token;
+	}
+
+	/*
+	 * Output through the write function a token c
+	 * preceded or followed by any required delimiters.
+	 */
+	template <ProcessingType PT, typename F>
+	void delimit(token_type c, F write) {
+		if constexpr (PT == PT_LINE)
+			lines_synchronize();
+		if constexpr (PT == PT_LINE || PT == PT_FILE) {
+			write();
+			*out << separator;
+		} else {
+			if (previously_in_method && !nesting.in_method()) {
+				write();
+				*out << '\n';
+			}
+			if (nesting.in_method()) {
+				write();
+				if (PT == PT_STATEMENT && c == ';')
+					*out << '\n';
+				else
+					*out << separator;
+			}
+		}
+		previously_in_method = nesting.in_method();
+	}
+
+	template <bool AllContents, ProcessingType PT, bool Compress>
+	void numeric_loop() {
+		token_type c;
+
+		previously_in_method = false;
+		while ((c = next_token<AllContents>())) {
+			if (Compress && !compress_token(c))
+				continue;
+			delimit<PT>(c, [this, c]() { *out << c; });
+		}
+
+		*out << '\n';
+	}
+
+	template <bool AllContents, ProcessingType PT>
+	void symbolic_loop() {
+		token_type c;
+
+		previously_in_method = false;
+		while ((c = next_token<AllContents>()))
+			delimit<PT>(c, [this, c]() {
+				if (TokenId::is_character(c))
+					*out << (char)c;
+				else if (TokenId::is_keyword(c))
+					*out << derived().Derived::keyword_to_string(c);
+				else if (TokenId::is_other_token(c))
+					*out << derived().Derived::token_to_string(c);
+				else if (TokenId::is_zero(c))
+					*out << "0";
+				else if (TokenId::is_number(c))
+					*out << "~1E" << c - TokenId::NUMBER_ZERO;
+				else if (TokenId::is_identifier(c))
+					*out << "ID:" << c;
+				else if (TokenId::is_hashed_content(c))
+					*out << "HASH:" << c;
+				else
+					assert(false);
+			});
+
+		*out << '\n';
+	}
+
+	template <bool AllContents, ProcessingType PT>
+	void type_loop() {
+		token_type c;
+
+		previously_in_method = false;
+		while ((c = next_token<AllContents>()))
+			delimit<PT>(c, [this, c]() {
+				if (TokenId::is_character(c))
+					*out << (char)c;
+				else if (TokenId::is_keyword(c))
+					*out << derived().Derived::keyword_to_string(c);
+				else if (TokenId::is_other_token(c))
+					*out << derived().Derived::token_to_string(c);
+				else if (TokenId::is_zero(c) ||
+				    TokenId::is_number(c))
+					*out << "NUM";
+				else if (TokenId::is_identifier(c))
+					*out << "ID";
+				else if (TokenId::is_hashed_content(c))
+					*out << "HASH";
+				else
+					assert(false);
+			});
+
+		*out << '\n';
+	}
+
+	// Output tab-separated the line, column, and offset of the last token
+	void output_position() {
+		*out << '\t' << position.line << '\t' << position.column <<
+			'\t' << position.offset;
+	}
+
+	template <bool AllContents, ProcessingType PT, bool Compress,
+		 bool Positions>
+	void binary_loop(BinaryWriter &writer) {
+		token_type c;
+		std::vector<token_type> unit;
+		std::vector<Position> unit_positions;
+
+		// Output the unit, followed by its tokens' positions
+		auto write_unit = [&]() {
+			writer.unit(unit);
+			unit.clear();
+			if constexpr (Positions) {
+				writer.positions(unit_positions);
+				unit_positions.clear();
+			}
+		};
+		// Add the token c to the unit
+		auto add = [&]() {
+			unit.push_back(c);
+			if constexpr (Positions)
+				unit_positions.push_back(position);
+		};
+
+		previously_in_method = false;
+		while ((c = next_token<AllContents, Positions>())) {
+			if (Compress && !compress_token(c))
+				continue;
+
+			if constexpr (PT == PT_LINE) {
+				// Synchronize the input line number with the unit
+				while (src.line_number() > output_line_number) {
+					write_unit();
+					output_line_number++;
+				}
+			}
+			if constexpr (PT == PT_LINE || PT == PT_FILE)
+				add();
+			else {
+				if (previously_in_method && !nesting.in_method()) {
+					add();
+					write_unit();
+				}
+				if (nesting.in_method()) {
+					add();
+					if (PT == PT_STATEMENT && c == ';')
+						write_unit();
+				}
+			}
+			previously_in_method = nesting.in_method();
+		}
+
+		// Methods and statements don't leave behind an empty unit
+		if (!unit.empty() || PT == PT_FILE || PT == PT_LINE)
+			write_unit();
+	}
+
+	/*
+	 * Pass the tokens to the add function, calling end_unit
+	 * at the end of the units that binary_loop() outputs.
+	 */
+	template <bool AllContents, ProcessingType PT, bool Compress,
+		 typename Add, typename End>
+	void unit_loop(Add add, End end_unit) {
+		token_type c;
+
+		previously_in_method = false;
+		while ((c = next_token<AllContents>())) {
+			if (Compress && !compress_token(c))
+				continue;
+
+			if constexpr (PT == PT_LINE) {
+				if (src.line_number() > output_line_number) {
+					end_unit();
+					output_line_number = src.line_number();
+				}
+			}
+			if constexpr (PT == PT_LINE || PT == PT_FILE)
+				add(c);
+			else {
+				if (previously_in_method && !nesting.in_method()) {
+					add(c);
+					end_unit();
+				}
+				if (nesting.in_method()) {
+					add(c);
+					if (PT == PT_STATEMENT && c == ';')
+						end_unit();
+				}
+			}
+			previously_in_method = nesting.in_method();
+		}
+		end_unit();
+	}
+
+	// Call f with unit_loop instantiated for the current settings
+	template <typename F>
+	void with_unit_loop(bool compress, F f) {
+		with_all_contents([this, compress, f](auto ac) {
+			with_processing_type([this, compress, f](auto pt) {
+				constexpr bool AC = decltype(ac)::value;
+				constexpr ProcessingType PT = decltype(pt)::value;
+				if (compress)
+					f([this](auto add, auto end) {
+						unit_loop<AC, PT, true>(add, end);
+					});
+				else
+					f([this](auto add, auto end) {
+						unit_loop<AC, PT, false>(add, end);
+					});
+			});
+		});
+	}
+
+	template <bool AllContents, bool Positions>
+	void code_loop() {
+		token_type c;
+
+		while ((c = next_token<AllContents, Positions>())) {
+			if (TokenId::is_character(c) && !isspace((unsigned char)c))
+				*out << (char)c;
+			else if (TokenId::is_keyword(c))
+				*out << derived().Derived::keyword_to_string(c);
+			else if (TokenId::is_other_token(c))
+				*out << derived().Derived::token_to_symbol(c);
+			else if (TokenId::is_zero(c))
+				*out << "0";
+			else if (TokenId::is_number(c))
+				*out << get_value();
+			else if (TokenId::is_identifier(c))
+				*out << get_value();
+			else if (TokenId::is_hashed_content(c))
+				*out << get_value();
+			else
+				assert(false);
+			if constexpr (Positions)
+				output_position();
+			*out << '\n';
+		}
+	}
+
+	template <bool AllContents, bool Positions>
+	void type_code_loop() {
+		token_type c;
+
+		while ((c = next_token<AllContents, Positions>())) {
+			if (TokenId::is_character(c) && !isspace((unsigned char)c))
+				*out << "TOK " << (char)c;
+			else if (TokenId::is_keyword(c))
+				*out << "KW " << derived().Derived::keyword_to_string(c);
+			else if (TokenId::is_other_token(c))
+				*out << "TOK " << derived().Derived::token_to_symbol(c);
+			else if (TokenId::is_zero(c))
+				*out << "NUM 0";
+			else if (TokenId::is_number(c))
+				*out << "NUM " << get_value();
+			else if (TokenId::is_identifier(c))
+				*out << "ID " << get_value();
+			else if (TokenId::is_hashed_content(c))
+				*out << "HASH " << get_value();
+			else
+				assert(false);
+			if constexpr (Positions)
+				output_position();
+			*out << '\n';
+		}
+	}
+protected:
+	token_type get_immediate_token() override {
+		if (all_contents)
+			return derived().Derived::template lex_token<true>();
+		else
+			return derived().Derived::template lex_token<false>();
+	}
+public:
+	using TokenizerBase::TokenizerBase;
+
+	void numeric_tokenize(bool compress) override {
+		with_all_contents([this, compress](auto ac) {
+			with_processing_type([this, compress](auto pt) {
+				constexpr bool AC = decltype(ac)::value;
+				constexpr ProcessingType PT = decltype(pt)::value;
+				if (compress)
+					numeric_loop<AC, PT, true>();
+				else
+					numeric_loop<AC, PT, false>();
+			});
+		});
+	}
+
+	void symbolic_tokenize() override {
+		with_all_contents([this](auto ac) {
+			with_processing_type([this](auto pt) {
+				symbolic_loop<decltype(ac)::value,
+					decltype(pt)::value>();
+			});
+		});
+	}
+
+	void type_tokenize() override {
+		with_all_contents([this](auto ac) {
+			with_processing_type([this](auto pt) {
+				type_loop<decltype(ac)::value,
+					decltype(pt)::value>();
+			});
+		});
+	}
+
+	void binary_tokenize(BinaryWriter &writer, bool compress) override {
+		with_all_contents([this, &writer, compress](auto ac) {
+			with_processing_type([this, &writer, compress, ac](auto pt) {
+				with_positions([this, &writer, compress, ac,
+						pt](auto p) {
+					constexpr bool AC = decltype(ac)::value;
+					constexpr ProcessingType PT =
+						decltype(pt)::value;
+					constexpr bool P = decltype(p)::value;
+					if (compress)
+						binary_loop<AC, PT, true, P>(writer);
+					else
+						binary_loop<AC, PT, false, P>(writer);
+				});
+			});
+		});
+	}
+
+	void ngram_tokenize(NgramCounter &counter, bool compress) override {
+		with_unit_loop(compress, [&counter](auto loop) {
+			loop([&counter](token_type c) { counter.add(c); },
+				[&counter]() { counter.end_unit(); });
+		});
+	}
+
+	void clone_tokenize(CloneDetector::FileUnits &units,
+			bool compress) override {
+		with_unit_loop(compress, [this, &units](auto loop) {
+			loop([this, &units](token_type c) {
+					units.add(c, src.line_number());
+				},
+				[&units]() { units.end_unit(); });
+		});
+	}
+
+	void minhash_tokenize(MinHash &m, bool compress) override {
+		with_unit_loop(compress, [this, &m](auto loop) {
+			loop([this, &m](token_type c) {
+					m.add(c, src.line_number());
+				},
+				[&m]() { m.end_unit(); });
+		});
+	}
+
+	void code_tokenize() override {
+		with_all_contents([this](auto ac) {
+			with_positions([this](auto p) {
+				code_loop<decltype(ac)::value,
+					decltype(p)::value>();
+			});
+		});
+	}
+
+	void type_code_tokenize() override {
+		with_all_contents([this](auto ac) {
+			with_positions([this](auto p) {
+				type_code_loop<decltype(ac)::value,
+					decltype(p)::value>();
+			});
+		});
+	}
+};
+#endif /* TOKENIZERIMPL_H */
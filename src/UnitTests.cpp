@@ -16,31 +16,48 @@
 
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "BinaryWriterTest.h"
 #include "BolStateTest.h"
+#include "ByteScanTest.h"
 #include "CharSourceTest.h"
 #include "CKeywordTest.h"
+#include "CloneDetectorTest.h"
+#include "ContentHashTest.h"
 #include "CTokenizerTest.h"
 #include "GoTokenizerTest.h"
 #include "CppTokenizerTest.h"
 #include "CSharpTokenizerTest.h"
+#include "IncrementalHashTest.h"
 #include "JavaTokenizerTest.h"
+#include "MinHashTest.h"
+#include "NgramCounterTest.h"
 #include "JavaScriptTokenizerTest.h"
 #include "PHPTokenizerTest.h"
 #include "PythonTokenizerTest.h"
 #include "RustTokenizerTest.h"
+#include "ServerTest.h"
 #include "TokenizerBaseTest.h"
+#include "TokenStreamTest.h"
 #include "TypeScriptTokenizerTest.h"
+#include "WorkerPoolTest.h"
 #include "SymbolTableTest.h"
+#include "TokenCacheTest.h"
 #include "NestedClassStateTest.h"
+#include "OutputSinkTest.h"
 
 int
 main(int argc, char *argv[])
 {
 	CppUnit::TextUi::TestRunner runner;
 
+	runner.addTest(BinaryWriterTest::suite());
 	runner.addTest(BolStateTest::suite());
+	runner.addTest(ByteScanTest::suite());
 	runner.addTest(CharSourceTest::suite());
 	runner.addTest(CKeywordTest::suite());
+	runner.addTest(CloneDetectorTest::suite());
+	runner.addTest(ContentHashTest::suite());
+	runner.addTest(IncrementalHashTest::suite());
 	runner.addTest(TokenizerBaseTest::suite());
 
 	runner.addTest(CTokenizerTest::suite());
@@ -53,9 +70,16 @@ main(int argc, char *argv[])
 	runner.addTest(PHPTokenizerTest::suite());
 	runner.addTest(JavaScriptTokenizerTest::suite());
 	runner.addTest(TypeScriptTokenizerTest::suite());
+	runner.addTest(TokenStreamTest::suite());
 
 	runner.addTest(SymbolTableTest::suite());
+	runner.addTest(MinHashTest::suite());
 	runner.addTest(NestedClassStateTest::suite());
+	runner.addTest(NgramCounterTest::suite());
+	runner.addTest(OutputSinkTest::suite());
+	runner.addTest(ServerTest::suite());
+	runner.addTest(TokenCacheTest::suite());
+	runner.addTest(WorkerPoolTest::suite());
 
 	runner.run();
 	return 0;
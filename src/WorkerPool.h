@@ -0,0 +1,139 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * A pool of threads that perform work on jobs concurrently,
+ * and complete them in the thread that added them, in the order
+ * they were added.
+ * At most a fixed number of jobs are in flight, which bounds the
+ * memory used for their results.
+ */
+template <typename Job>
+class WorkerPool {
+	// A job and its state
+	struct Slot {
+		Job job;
+		bool done;
+		Slot(Job &&j) : job(std::move(j)), done(false) {}
+	};
+
+	std::function<void(Job &)> work;	// Performed by the workers
+	std::function<void(Job &)> complete;	// Performed in order
+	size_t max_slots;		// Maximum number of jobs in flight
+	std::deque<std::unique_ptr<Slot>> slots;	// Jobs in order
+	std::queue<Slot *> pending;	// Jobs not yet taken by a worker
+	std::vector<std::thread> threads;
+	bool stopping;			// True when workers must exit
+	std::mutex mutex;		// Protects all the above
+	std::condition_variable work_available;
+	std::condition_variable work_done;
+
+	// Perform the work of pending jobs until the pool is stopped
+	void worker() {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		for (;;) {
+			work_available.wait(lock, [this] {
+				return stopping || !pending.empty();
+			});
+			if (pending.empty())
+				return;
+			Slot *s = pending.front();
+			pending.pop();
+
+			lock.unlock();
+			work(s->job);
+			lock.lock();
+
+			s->done = true;
+			if (s == slots.front().get())
+				work_done.notify_one();
+		}
+	}
+
+	// Wait for the oldest job to finish, and complete it
+	void complete_oldest(std::unique_lock<std::mutex> &lock) {
+		work_done.wait(lock, [this] { return slots.front()->done; });
+		std::unique_ptr<Slot> s(std::move(slots.front()));
+		slots.pop_front();
+
+		lock.unlock();
+		complete(s->job);
+		lock.lock();
+	}
+public:
+	/**
+	 * Create a pool with the specified number of threads,
+	 * which perform the work function on each job.
+	 * The complete function is then called on each job, in order,
+	 * by the thread adding the jobs.
+	 */
+	WorkerPool(int nthreads, std::function<void(Job &)> w,
+			std::function<void(Job &)> c) :
+		work(w), complete(c), max_slots(4 * nthreads),
+		stopping(false) {
+		for (int i = 0; i < nthreads; i++)
+			threads.emplace_back(&WorkerPool::worker, this);
+	}
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	~WorkerPool() { finish(); }
+
+	/**
+	 * Add the specified job to the pool.
+	 * If too many jobs are in flight, first wait for the oldest one
+	 * to finish, and complete it.
+	 */
+	void add(Job job) {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (slots.size() >= max_slots)
+			complete_oldest(lock);
+		slots.emplace_back(new Slot(std::move(job)));
+		pending.push(slots.back().get());
+		work_available.notify_one();
+	}
+
+	/** Complete all jobs added to the pool, and stop its threads */
+	void finish() {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (!slots.empty())
+			complete_oldest(lock);
+		stopping = true;
+		work_available.notify_all();
+		lock.unlock();
+
+		for (auto &t : threads)
+			t.join();
+		threads.clear();
+	}
+};
+#endif /* WORKERPOOL_H */
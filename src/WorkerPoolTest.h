@@ -0,0 +1,106 @@
+/*-
+ * Copyright 2026 Diomidis Spinellis
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#ifndef WORKERPOOLTEST_H
+#define WORKERPOOLTEST_H
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CTokenizer.h"
+#include "WorkerPool.h"
+
+class WorkerPoolTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(WorkerPoolTest);
+	CPPUNIT_TEST(testOrder);
+	CPPUNIT_TEST(testInFlight);
+	CPPUNIT_TEST(testEmpty);
+	CPPUNIT_TEST(testErrorOutput);
+	CPPUNIT_TEST_SUITE_END();
+
+	struct Job {
+		int n;
+		int result;
+		Job(int v) : n(v), result(0) {}
+	};
+public:
+	// Jobs finishing out of order are completed in order
+	void testOrder() {
+		std::vector<int> completed;
+
+		WorkerPool<Job> pool(4, [](Job &j) {
+				// Later jobs finish earlier
+				std::this_thread::sleep_for(
+					std::chrono::microseconds(100 * (j.n % 8)));
+				j.result = j.n * j.n;
+			}, [&completed](Job &j) {
+				CPPUNIT_ASSERT_EQUAL(j.n * j.n, j.result);
+				completed.push_back(j.n);
+			});
+		for (int i = 0; i < 100; i++)
+			pool.add(Job(100 - i));
+		pool.finish();
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100), completed.size());
+		for (int i = 0; i < 100; i++)
+			CPPUNIT_ASSERT_EQUAL(100 - i, completed[i]);
+	}
+
+	// The number of jobs in flight is bounded
+	void testInFlight() {
+		std::atomic<int> started(0);
+		int ncompleted = 0;
+
+		WorkerPool<Job> pool(2, [&started](Job &) {
+				started++;
+			}, [&ncompleted](Job &) {
+				ncompleted++;
+			});
+		for (int i = 0; i < 1000; i++) {
+			pool.add(Job(i));
+			CPPUNIT_ASSERT(i + 1 - ncompleted <= 8);
+		}
+		pool.finish();
+		CPPUNIT_ASSERT_EQUAL(1000, started.load());
+		CPPUNIT_ASSERT_EQUAL(1000, ncompleted);
+	}
+
+	void testEmpty() {
+		int ncompleted = 0;
+		{
+			WorkerPool<Job> pool(3, [](Job &) {},
+				[&ncompleted](Job &) { ncompleted++; });
+		}
+		CPPUNIT_ASSERT_EQUAL(0, ncompleted);
+	}
+
+	// Tokenizer errors can be kept with each job's results
+	void testErrorOutput() {
+		std::ostringstream err;
+		CTokenizer ct("/* unterminated");
+
+		ct.set_error(err);
+		(void)ct.get_token();
+		CPPUNIT_ASSERT_EQUAL(std::string("(string)(1): EOF encountered "
+			"while processing a block comment\n"), err.str());
+	}
+};
+#endif /* WORKERPOOLTEST_H */
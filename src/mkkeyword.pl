@@ -13,6 +13,9 @@ my @keywords;
 my @languages;
 my %keyword_languages;
 my %type_languages;
+my %language_keywords;
+my %hash_size;
+my %hash_max_length;
 
 for my $in_fname (@ARGV) {
 
@@ -27,6 +30,7 @@ for my $in_fname (@ARGV) {
 		my ($keyword, $is_type) = split;
 		$keywords{$keyword} = 1;
 		push @{$keyword_languages{$keyword}}, "li == L_$language";
+		$language_keywords{$language}{$keyword} = 1;
 		if ($is_type) {
 			push @{$type_languages{$keyword}}, "li == L_$language";
 		}
@@ -43,9 +47,13 @@ print $out qq(
 #ifndef KEYWORD_H
 #define KEYWORD_H
 
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <map>
 #include <set>
 #include <string>
+#include <string_view>
 
 #include "TokenId.h"
 #include "CollectionViews.h"
@@ -76,60 +84,101 @@ for my $lang (sort @languages) {
 print $out "
 	};
 private:
-	// Keyword map
-	typedef std::map <std::string, enum IdentifierType> KeywordMap;
 	typedef std::map <token_type, std::string> TokenMap;
 	typedef std::set <token_type> TypeTokens;
-	KeywordMap km;
-	TokenMap tm;
-	TypeTokens tt;
-public:
-	// Create a keyword recognizer for the specified language
-	Keyword(enum LanguageId li) : km(), tt() {
-";
 
-# Shuffle to avoid presenting sorted data to the map
-for my $k (shuffle @keywords) {
-	my $keyword_condition = join(" || ", @{$keyword_languages{$k}});
-	print $out qq(\t\tif ($keyword_condition)\n);
-	print $out qq(\t\t\tkm.emplace("$k", K_$k);\n);
+	// A language's type tokens
+	struct LanguageTables {
+		TypeTokens tt;
+		LanguageTables(enum LanguageId li);
+	};
 
-	if (defined($type_languages{$k})) {
-		my $type_condition = join(" || ", @{$type_languages{$k}});
-		print $out qq(\t\tif ($type_condition)\n);
-		print $out qq(\t\t\ttt.insert(K_$k);\n);
+	// An entry of a keyword perfect hash table
+	struct HashEntry {
+		const char *name;
+		size_t length;
+		enum IdentifierType id;
+	};
+
+	/*
+	 * A minimal perfect hash table of a language's keywords.
+	 * A keyword's bucket, hash(0, keyword) % size, holds a displacement.
+	 * Negative displacements d directly give the keyword's entry as
+	 * -d - 1; others give it as hash(d, keyword) % size.
+	 */
+	struct HashTable {
+		const int *displacement;
+		const HashEntry *entry;
+		uint32_t size;
+		size_t max_length;	// Length of the longest keyword
+	};
+
+	const LanguageTables &lt;	// Shared tables of our language
+	const HashTable &ht;		// Shared keyword hash table
+	const TokenMap &tm;		// Shared names of all keywords
+
+	// Return the FNV-1a hash of s, varied by the specified seed
+	static uint32_t hash(uint32_t seed, std::string_view s) {
+		uint32_t h = seed ^ 2166136261u;
+
+		for (unsigned char c : s)
+			h = (h ^ c) * 16777619u;
+		return h;
 	}
-}
 
-print $out '
-		tm = {
-';
+	// Return the keyword hash table of the specified language
+	static const HashTable &hash_table(enum LanguageId li);
 
-for my $k (shuffle @keywords) {
-	print $out qq(\t\t\t{K_$k, "$k" },\n);
+	/*
+	 * Return the tables of the specified language.
+	 * These are built once, when first used, and shared by all
+	 * keyword recognizers of the language.
+	 */
+	static const LanguageTables &language_tables(enum LanguageId li) {
+		switch (li) {
+";
+
+for my $lang (sort @languages) {
+	print $out "\t\tcase L_$lang: {\n";
+	print $out "\t\t\tstatic const LanguageTables t(L_$lang);\n";
+	print $out "\t\t\treturn t;\n";
+	print $out "\t\t}\n";
 }
 
-print $out qq|
-		};
+print $out "		}
+		abort();
 	}
 
-	enum IdentifierType identifier_type(const std::string &s) {
-		auto f = km.find(s);
-		if (f == km.end())
+	// Return the names of all keywords
+	static const TokenMap &token_map();
+public:
+	// Create a keyword recognizer for the specified language
+	Keyword(enum LanguageId li) : lt(language_tables(li)),
+		ht(hash_table(li)), tm(token_map()) {}
+
+	enum IdentifierType identifier_type(std::string_view s) const {
+		if (s.size() > ht.max_length)
 			return FIRST_IDENTIFIER;
+
+		int d = ht.displacement[hash(0, s) % ht.size];
+		const HashEntry &e = ht.entry[d < 0 ? -d - 1 :
+			hash(d, s) % ht.size];
+		if (e.length == s.size() &&
+		    memcmp(e.name, s.data(), s.size()) == 0)
+			return e.id;
 		else
-			return f->second;
+			return FIRST_IDENTIFIER;
 	}
 
 	const std::string & to_string(token_type k) const {
-		static const std::string UNKNOWN("???");
+		static const std::string UNKNOWN(\"???\");
 
 		auto t = tm.find(k);
 		return t == tm.end() ? UNKNOWN : t->second;
 	}
 
 	bool is_type(token_type k) const {
-		return tt.find(k) != tt.end();
+		return lt.tt.find(k) != lt.tt.end();
 	}
 
 	// Return an iterator over the keyword symbols
@@ -137,5 +186,140 @@ print $out qq|
 		return tm;
 	}
 };
+
+// Fill the tables with the type tokens of the specified language
+inline
+Keyword::LanguageTables::LanguageTables(enum LanguageId li)
+{
+";
+
+# Shuffle to avoid presenting sorted data to the set
+for my $k (shuffle @keywords) {
+	if (defined($type_languages{$k})) {
+		my $type_condition = join(" || ", @{$type_languages{$k}});
+		print $out qq(\tif ($type_condition)\n);
+		print $out qq(\t\ttt.insert(K_$k);\n);
+	}
+}
+
+print $out '}
+
+inline const Keyword::TokenMap &
+Keyword::token_map()
+{
+	static const TokenMap tm = {
+';
+
+for my $k (shuffle @keywords) {
+	print $out qq(\t\t{K_$k, "$k" },\n);
+}
+
+print $out qq|	};
+	return tm;
+}
+
+// Perfect hash tables generated from the keywords of each language
+inline const Keyword::HashTable &
+Keyword::hash_table(enum LanguageId li)
+{
+|;
+
+for my $lang (sort @languages) {
+	my ($displacement, $entry) = perfect_hash(keys %{$language_keywords{$lang}});
+	my $max_length = 0;
+	for my $k (keys %{$language_keywords{$lang}}) {
+		$max_length = length($k) if (length($k) > $max_length);
+	}
+
+	print $out "\tstatic const int ${lang}_displacement[] = {";
+	for (my $i = 0; $i <= $#$displacement; $i++) {
+		print $out ($i % 10 == 0 ? "\n\t\t" : ' '), $displacement->[$i], ',';
+	}
+	print $out "\n\t};\n";
+
+	print $out "\tstatic const HashEntry ${lang}_entry[] = {\n";
+	for my $k (@$entry) {
+		print $out qq(\t\t{"$k", ), length($k), ", K_$k},\n";
+	}
+	print $out "\t};\n";
+	$hash_size{$lang} = scalar(@$entry);
+	$hash_max_length{$lang} = $max_length;
+}
+
+print $out "\tstatic const HashTable table[] = {\n";
+for my $lang (sort @languages) {
+	print $out "\t\t{${lang}_displacement, ${lang}_entry, ",
+		"$hash_size{$lang}, $hash_max_length{$lang}},\n";
+}
+print $out qq|	};
+	return table[li];
+}
 #endif /* KEYWORD_H */
 |;
+
+# Return the 32-bit FNV-1a hash of the specified string, varied by the seed
+# This must match Keyword::hash()
+sub
+fnv_hash
+{
+	my ($seed, $s) = @_;
+	my $h = $seed ^ 2166136261;
+
+	for my $c (unpack('C*', $s)) {
+		$h = (($h ^ $c) * 16777619) & 0xffffffff;
+	}
+	return $h;
+}
+
+# Return references to the displacement and entry arrays of a minimal
+# perfect hash table for the specified keywords (hash and displace)
+sub
+perfect_hash
+{
+	my (@keys) = sort @_;
+	my $n = scalar(@keys);
+	my @buckets;
+	my @displacement = (0) x $n;
+	my @entry = (undef) x $n;
+
+	for my $k (@keys) {
+		push(@{$buckets[fnv_hash(0, $k) % $n]}, $k);
+	}
+
+	# Place keys of the largest buckets first
+	my @order = sort {
+		scalar(@{$buckets[$b] // []}) <=> scalar(@{$buckets[$a] // []})
+		|| $a <=> $b } (0 .. $n - 1);
+
+	for my $i (@order) {
+		my @bucket = @{$buckets[$i] // []};
+		last if (@bucket <= 1);
+
+		# Find a displacement that places all the bucket's keys
+		# in distinct free entries
+		DISPLACEMENT: for (my $d = 1; ; $d++) {
+			my %used;
+			for my $k (@bucket) {
+				my $e = fnv_hash($d, $k) % $n;
+				next DISPLACEMENT if (defined($entry[$e]) || $used{$e});
+				$used{$e} = 1;
+			}
+			for my $k (@bucket) {
+				$entry[fnv_hash($d, $k) % $n] = $k;
+			}
+			$displacement[$i] = $d;
+			last;
+		}
+	}
+
+	# Place single keys directly in the remaining free entries
+	my @free = grep { !defined($entry[$_]) } (0 .. $n - 1);
+	for my $i (@order) {
+		my @bucket = @{$buckets[$i] // []};
+		next unless (@bucket == 1);
+		my $e = shift(@free);
+		$entry[$e] = $bucket[0];
+		$displacement[$i] = -$e - 1;
+	}
+	return (\@displacement, \@entry);
+}
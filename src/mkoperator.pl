@@ -0,0 +1,143 @@
+#!/usr/bin/env perl
+#
+# Create from each language's operator list a deterministic automaton
+# that recognizes the longest operator starting at the input
+#
+
+use strict;
+use warnings;
+
+my @languages;
+my %language_operators;
+my $max_length = 0;
+
+for my $in_fname (@ARGV) {
+
+	my $language = $in_fname;
+	$language =~ s/\-operator\.txt//;
+	push(@languages, $language);
+
+	open(my $in, '<', $in_fname) || die "Unable to open $in_fname: $!\n";
+	while (<$in>) {
+		s/\r//g;
+		chop;
+		next if (/^\s*$/);
+		my ($symbol, $name) = split;
+		if (length($symbol) > 1 && !defined($name)) {
+			die "$in_fname: Operator $symbol has no token name\n";
+		}
+		$language_operators{$language}{$symbol} =
+			defined($name) ? "Token::$name" : char_literal($symbol);
+		$max_length = length($symbol) if (length($symbol) > $max_length);
+	}
+}
+
+my $out_fname = "Operator.h";
+open(my $out, '>', $out_fname) || die "Unable to open $out_fname: $!\n";
+
+print $out qq(
+// Automatically generated file.  See $0.
+
+#ifndef OPERATOR_H
+#define OPERATOR_H
+
+#include <cstdint>
+
+#include "Token.h"
+
+/**
+ * Longest-match recognizers of each language's operators.
+ * A recognizer is a deterministic automaton on the classes of the
+ * characters that can appear in operators. Its state 0 is the initial
+ * one and also denotes the absence of a transition.
+ */
+class Operator {
+public:
+	// Length of the longest operator of any language
+	static constexpr int MAX_LENGTH = $max_length;
+
+	struct Table {
+		const uint8_t *char_class;	// Class of each ASCII character
+		const uint8_t *next;		// Next state for a state and class
+		const token_type *accept;	// Token of each state, or 0
+		int nclasses;			// Number of classes, including 0
+	};
+private:
+);
+
+my %nclasses;
+for my $lang (sort @languages) {
+	my %operators = %{$language_operators{$lang}};
+
+	# Characters not used in operators belong to class 0
+	my %char_class;
+	my $nclasses = 1;
+	for my $c (sort map { split(//) } keys %operators) {
+		$char_class{$c} = $nclasses++ unless (defined($char_class{$c}));
+	}
+	$nclasses{$lang} = $nclasses;
+
+	# Build a trie of the operators; its nodes are the automaton states
+	my @next = ([]);
+	my @accept = ('0');
+	for my $op (sort keys %operators) {
+		my $state = 0;
+		for my $c (split(//, $op)) {
+			my $class = $char_class{$c};
+			if (!$next[$state][$class]) {
+				push(@next, []);
+				push(@accept, '0');
+				$next[$state][$class] = $#next;
+			}
+			$state = $next[$state][$class];
+		}
+		$accept[$state] = $operators{$op};
+	}
+	die "$lang: Too many operator states\n" if (@next > 256);
+	# An operator's first character must also be an operator
+	for my $state (@{$next[0]}) {
+		die "$lang: Missing single character operator\n"
+			if (defined($state) && $accept[$state] eq '0');
+	}
+
+	print $out "\tstatic constexpr uint8_t ${lang}_char_class[128] = {";
+	for my $i (0 .. 127) {
+		my $class = $char_class{chr($i)} // 0;
+		print $out ($i % 16 == 0 ? "\n\t\t" : ' '), $class, ',';
+	}
+	print $out "\n\t};\n";
+
+	print $out "\tstatic constexpr uint8_t ${lang}_next[] = {\n";
+	for my $state (0 .. $#next) {
+		print $out "\t\t", join(', ',
+			map { $next[$state][$_] // 0 } (0 .. $nclasses - 1)),
+			",\n";
+	}
+	print $out "\t};\n";
+
+	print $out "\tstatic constexpr token_type ${lang}_accept[] = {\n";
+	for my $state (0 .. $#next) {
+		print $out "\t\t$accept[$state],\n";
+	}
+	print $out "\t};\n";
+}
+
+print $out "public:\n";
+for my $lang (sort @languages) {
+	print $out "\tstatic constexpr Table $lang = {${lang}_char_class, ",
+		"${lang}_next, ${lang}_accept, $nclasses{$lang}};\n";
+}
+
+print $out qq|};
+#endif /* OPERATOR_H */
+|;
+
+# Return the C++ character literal of the specified character
+sub
+char_literal
+{
+	my ($c) = @_;
+
+	return "'\\$c'" if ($c eq '\\' || $c eq "'");
+	return "'$c'";
+}
@@ -1,6 +1,6 @@
 #!/usr/bin/env perl
 #
-# Find token uses in the specified language tokenizer files
+# Find token uses in the specified language tokenizer and operator files
 # and generate a global tokens enumeration file
 #
 
@@ -9,16 +9,27 @@ use warnings;
 use List::Util qw(shuffle);
 
 my %token_symbol;
+my %operator_symbol;
 
 for my $in_fname (@ARGV) {
 	open(my $in, '<', $in_fname) || die "Unable to open $in_fname: $!\n";
 	while (<$in>) {
 		s/\r//g;
 		chop;
-		$token_symbol{$1} = $2 if (/\bToken\:\:(\w+);\s+\/\/\s+(.*)/);
+		if ($in_fname =~ /\-operator\.txt$/) {
+			my ($symbol, $name) = split;
+			$operator_symbol{$name} = c_string($symbol) if (defined($name));
+		} else {
+			$token_symbol{$1} = $2 if (/\bToken\:\:(\w+);\s+\/\/\s+(.*)/);
+		}
 	}
 }
 
+# Symbols given in the tokenizer code take precedence
+for my $t (keys %operator_symbol) {
+	$token_symbol{$t} = $operator_symbol{$t} unless (defined($token_symbol{$t}));
+}
+
 my $out_fname = "Token.h";
 open(my $out, '>', $out_fname) || die "Unable to open $out_fname: $!\n";
 
@@ -30,6 +41,9 @@ print $out qq|
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <map>
+#include <string>
+
 #include "TokenId.h"
 #include "CollectionViews.h"
 
@@ -95,3 +109,15 @@ print $out qq|
 };
 #endif /* TOKEN_H */
 |;
+
+# Return the specified symbol as the contents of a C++ string literal
+sub
+c_string
+{
+	my ($s) = @_;
+
+	$s =~ s/([\\"])/\\$1/g;
+	# Avoid trigraphs
+	$s =~ s/\?\?/?\\?/g;
+	return $s;
+}
@@ -14,27 +14,38 @@
  *   limitations under the License.
  */
 
+#include <csignal>
+#include <cstdio>
 #include <cstring>
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <optional>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include "errno.h"
+#include "fcntl.h"
 #include "unistd.h"
 
+#include "BinaryWriter.h"
+#include "CloneDetector.h"
+#include "LshIndex.h"
+#include "MinHash.h"
+#include "NgramCounter.h"
+#include "OutputSink.h"
+#include "Server.h"
 #include "SymbolTable.h"
-#include "CTokenizer.h"
-#include "CppTokenizer.h"
-#include "CSharpTokenizer.h"
-#include "GoTokenizer.h"
-#include "JavaTokenizer.h"
-#include "JavaScriptTokenizer.h"
-#include "PHPTokenizer.h"
-#include "PythonTokenizer.h"
-#include "RustTokenizer.h"
+#include "Token.h"
+#include "TokenCache.h"
+#include "TokenizerBase.h"
+#include "TokenStream.h"
+#include "WorkerPool.h"
 
 const char version[] = "2.8.1";
 
@@ -43,64 +54,174 @@ static bool all_contents = false;
 static bool symbolic_output = false;
 static bool compress_ids = false;
 static bool show_file_name = false;
+static bool positions = false;
+static bool global_scope = false;
 static enum output_type {
 	ot_tokens,	// Numeric or symbolic tokens
 	ot_break, 	// Original tokens broken into lines
 	ot_type_break,	// As above, tokens preceded by their type
+	ot_binary,	// Numeric tokens in binary form
 } output_type = ot_tokens;
+static BinaryWriter::Encoding binary_encoding = BinaryWriter::UINT32;
 static std::string lang("Java");
 static std::vector<std::string> processing_opt;
 static char separator;
+static int jobs = 1;
+static std::optional<std::string> cache_dir(std::nullopt);
+static uint64_t cache_size = 1024;	// In megabytes
+static std::optional<std::string> files_list(std::nullopt);
+static unsigned ngram_length = 0;	// Zero if n-grams aren't counted
+static uint64_t ngram_memory = 1024;	// In megabytes
+static unsigned clone_tokens = 0;	// Zero if clones aren't detected
+static unsigned minhash_hashes = 0;	// Zero if no signatures are output
+static unsigned shingle_width = 4;
+static unsigned band_rows = 4;
+static std::optional<std::string> index_output(std::nullopt);
+static std::optional<std::string> index_query(std::nullopt);
+static std::optional<std::string> server_socket(std::nullopt);
+static std::optional<std::string> remote_socket(std::nullopt);
+
+// A file tokenized by a worker thread
+struct FileJob {
+	std::string filename;
+	std::unique_ptr<OutputSink> out;	// The file's output
+	std::string errors;			// The file's error messages
+	bool ok;				// False if the file can't be opened
+	FileJob(const std::string &f) : filename(f), ok(true) {}
+};
+
+// Pool tokenizing the named files concurrently, when -j is specified
+static std::unique_ptr<WorkerPool<FileJob>> pool;
+
+// Cache of the files' output, when -C is specified
+static std::unique_ptr<TokenCache> cache;
+
+// N-gram counters of each thread, when -n is specified
+static std::map<std::thread::id, std::unique_ptr<NgramCounter>> ngram_counters;
+static std::mutex ngram_counters_mutex;
+
+// Detector of the files' clones, when -d is specified
+static std::unique_ptr<CloneDetector> clones;
+
+// Builder of the index written with -x
+static std::unique_ptr<LshIndex::Builder> index_builder;
+
+// Index queried with -q
+static std::unique_ptr<LshIndex> index_queried;
+
+// Return the n-gram counter of the calling thread
+static NgramCounter &
+thread_ngram_counter()
+{
+	std::lock_guard<std::mutex> lock(ngram_counters_mutex);
+
+	auto &counter = ngram_counters[std::this_thread::get_id()];
+	if (!counter)
+		counter.reset(new NgramCounter(ngram_length,
+			(ngram_memory << 20) / jobs));
+	return *counter;
+}
+
+// Return a new tokenizer for the specified character source
+static TokenizerBase *
+new_tokenizer(CharSource &cs, const std::string &filename)
+{
+	return TokenizerBase::new_tokenizer(lang, cs, filename, processing_opt);
+}
+
+// Report an unsupported language
+static void
+unknown_language(std::ostream &err)
+{
+	err << "Unknown language specified." << std::endl;
+	err << "The following languages are supported:" << std::endl;
+	err << "\tC" << std::endl;
+	err << "\tCSharp (or C#)" << std::endl;
+	err << "\tC++" << std::endl;
+	err << "\tGo" << std::endl;
+	err << "\tJava" << std::endl;
+	err << "\tJavaScript" << std::endl;
+	err << "\tPHP" << std::endl;
+	err << "\tPython" << std::endl;
+	err << "\tRust" << std::endl;
+	err << "\tTypeScript" << std::endl;
+}
 
 /*
- * Process and print the metrics of the specified stream,
- * which is identified with the specified filename.
+ * Output the MinHash signatures of the units of the named file,
+ * or add them to the index being built,
+ * or output the indexed units similar to each of them.
  */
 static void
-process_file(std::istream &in, std::string filename)
+output_signatures(const MinHash &m, const std::string &filename,
+		OutputSink &out)
 {
-	CharSource cs(in);
-	TokenizerBase *t;
-
-	if (lang == "C")
-		t = new CTokenizer(cs, filename, processing_opt);
-	else if (lang == "CSharp" || lang == "C#")
-		t = new CSharpTokenizer(cs, filename, processing_opt);
-	else if (lang == "Go")
-		t = new GoTokenizer(cs, filename, processing_opt);
-	else if (lang == "Java")
-		t = new JavaTokenizer(cs, filename, processing_opt);
-	else if (lang == "JavaScript")
-		t = new JavaScriptTokenizer(cs, filename, processing_opt);
-	else if (lang == "C++")
-		t = new CppTokenizer(cs, filename, processing_opt);
-	else if (lang == "PHP")
-		t = new PHPTokenizer(cs, filename, processing_opt);
-	else if (lang == "Python")
-		t = new PythonTokenizer(cs, filename, processing_opt);
-	else if (lang == "Rust")
-		t = new RustTokenizer(cs, filename, processing_opt);
-	else if (lang == "TypeScript")
-		t = new JavaScriptTokenizer(cs, filename, processing_opt,
-				Keyword::L_TypeScript);
-	else {
-		std::cerr << "Unknown language specified." << std::endl;
-		std::cerr << "The following languages are supported:" << std::endl;
-		std::cerr << "\tC" << std::endl;
-		std::cerr << "\tCSharp (or C#)" << std::endl;
-		std::cerr << "\tC++" << std::endl;
-		std::cerr << "\tGo" << std::endl;
-		std::cerr << "\tJava" << std::endl;
-		std::cerr << "\tJavaScript" << std::endl;
-		std::cerr << "\tPHP" << std::endl;
-		std::cerr << "\tPython" << std::endl;
-		std::cerr << "\tRust" << std::endl;
-		std::cerr << "\tTypeScript" << std::endl;
-		exit(EXIT_FAILURE);
+	if (index_builder) {
+		index_builder->add_file(filename, m);
+		return;
 	}
 
+	for (size_t i = 0; i < m.size(); i++) {
+		const uint32_t *s = m.signature(i);
+		if (index_queried) {
+			const MinHash::Unit &u = m.get_unit(i);
+			index_queried->query(s, [&](const LshIndex::Match &r) {
+				char similarity[16];
+				snprintf(similarity, sizeof(similarity), "%.3f",
+					static_cast<double>(r.nequal) /
+					minhash_hashes);
+				out << filename << '\t' << u.begin << '\t' <<
+					u.end << '\t' << r.file << '\t' <<
+					r.begin << '\t' << r.end << '\t' <<
+					similarity << '\n';
+			});
+		} else if (output_type == ot_binary)
+			BinaryWriter(out, binary_encoding).signature(s,
+				minhash_hashes);
+		else {
+			char sep = separator ? separator : '\t';
+			for (unsigned j = 0; j < minhash_hashes; j++) {
+				if (j)
+					out << sep;
+				out << s[j];
+			}
+			out << '\n';
+		}
+	}
+}
+
+/*
+ * Tokenize the specified character source, which is identified with
+ * the specified filename, to the specified output and error streams.
+ */
+static void
+tokenize(CharSource &cs, const std::string &filename, OutputSink &out,
+		std::ostream &err)
+{
+	// The language is verified before tokenizing any input
+	std::unique_ptr<TokenizerBase> t(new_tokenizer(cs, filename));
+
+	t->set_output(out);
+	t->set_error(err);
 	t->set_separator(separator ? separator : ' ');
 	t->set_all_contents(all_contents);
+	t->set_positions(positions);
+	if (ngram_length) {
+		t->ngram_tokenize(thread_ngram_counter(), compress_ids);
+		return;
+	}
+	if (clone_tokens) {
+		CloneDetector::FileUnits units;
+		t->clone_tokenize(units, compress_ids);
+		clones->add_file(filename, units);
+		return;
+	}
+	if (minhash_hashes) {
+		MinHash m(minhash_hashes, shingle_width);
+		t->minhash_tokenize(m, compress_ids);
+		output_signatures(m, filename, out);
+		return;
+	}
 	switch (output_type) {
 	case ot_tokens:
 		if (symbolic_output) {
@@ -119,90 +240,323 @@ process_file(std::istream &in, std::string filename)
 	case ot_break:
 		t->code_tokenize();
 		break;
+	case ot_binary:
+		{
+			BinaryWriter writer(out, binary_encoding);
+			t->binary_tokenize(writer, compress_ids);
+		}
+		break;
+	}
+}
+
+/*
+ * Tokenize the specified character source, like tokenize(),
+ * but output the cached tokens of previously seen contents,
+ * and cache the tokens of new ones.
+ * Tokens are only cached if tokenizing them reported no errors,
+ * because the messages contain the name of the file.
+ */
+static void
+cached_tokenize(CharSource &cs, const std::string &filename,
+		OutputSink &out, std::ostream &err)
+{
+	std::string_view contents(cs.contents());
+	if (contents.empty()) {
+		tokenize(cs, filename, out, err);
+		return;
 	}
+
+	std::string entry(cache->entry(contents));
+	if (cache->get(entry, out))
+		return;
+
+	OutputSink tokens;
+	std::ostringstream errors;
+	tokenize(cs, filename, tokens, errors);
+	if (errors.str().empty())
+		cache->put(entry, tokens.str());
+	else
+		err << errors.str();
+	out << tokens.str();
+}
+
+/*
+ * Process and print the metrics of the specified character source,
+ * which is identified with the specified filename,
+ * to the specified output and error streams.
+ */
+static void
+process_file(CharSource &cs, std::string filename, OutputSink &out,
+		std::ostream &err)
+{
+	// The binary output always contains file records
+	if (output_type == ot_binary && !ngram_length)
+		BinaryWriter(out, binary_encoding).file(filename);
+	if (cache)
+		cached_tokenize(cs, filename, out, err);
+	else
+		tokenize(cs, filename, out, err);
+}
+
+// Return the options that affect the output, for identifying cached output
+static std::string
+output_options()
+{
+	std::ostringstream s;
+
+	s << version << ' ' << lang << " -" <<
+		(all_contents ? "a" : "") <<
+		(symbolic_output ? "s" : "") <<
+		(compress_ids ? "c" : "") <<
+		(positions ? "p" : "") <<
+		(global_scope ? "g" : "") <<
+		" type " << output_type <<
+		" enc " << binary_encoding <<
+		" sep " << static_cast<int>(separator);
+	for (auto &o : processing_opt)
+		s << " -o " << o;
+	if (minhash_hashes)
+		s << " -k " << minhash_hashes << " -w " << shingle_width;
+	return s.str();
+}
+
+// Output the header of the binary output format
+static void
+binary_header(OutputSink &out)
+{
+	unsigned char flags = 0;
+
+	if (compress_ids)
+		flags |= BinaryWriter::COMPRESSED;
+	if (all_contents)
+		flags |= BinaryWriter::ALL_CONTENTS;
+	if (positions)
+		flags |= BinaryWriter::POSITIONS;
+	if (ngram_length)
+		flags |= BinaryWriter::NGRAMS;
+	if (minhash_hashes)
+		flags |= BinaryWriter::SIGNATURES;
+	BinaryWriter writer(out, binary_encoding);
+	writer.header(lang == "C#" ? "CSharp" : lang,
+		TokenizerBase::processing_option(processing_opt), flags);
 }
 
 // List the values of all tokens
 static void
-list_tokens()
+list_tokens(std::ostream &out)
 {
 	// Characters (ASCII assumed)
 	for (char c = ' '; c <= '~'; c++)
-		std::cout << static_cast<int>(c) << '\t' << c << std::endl;
+		out << static_cast<int>(c) << '\t' << c << std::endl;
 
 	// Character symbol tokens (e.g. +=)
 	Token t;
 	for (auto ti: t.token_symbol_view())
-		std::cout << ti.first << '\t' << ti.second << std::endl;
+		out << ti.first << '\t' << ti.second << std::endl;
 
 	// Keywords (e.g. "if")
 	// Language is irrelevant for token_keyword_view
 	Keyword k(Keyword::L_C);
 	for (auto ki: k.token_keyword_view())
-		std::cout << ki.first << '\t' << ki.second << std::endl;
+		out << ki.first << '\t' << ki.second << std::endl;
 
 	// Compressed token identifiers
-	std::cout << TokenId::ANY_TYPE << "\tANY_TYPE" << std::endl;
-	std::cout << TokenId::ANY_HASH << "\tANY_HASH" << std::endl;
-	std::cout << TokenId::ANY_NUMBER << "\tANY_NUMBER" << std::endl;
-	std::cout << TokenId::ANY_IDENTIFIER << "\tANY_IDENTIFIER" << std::endl;
+	out << TokenId::ANY_TYPE << "\tANY_TYPE" << std::endl;
+	out << TokenId::ANY_HASH << "\tANY_HASH" << std::endl;
+	out << TokenId::ANY_NUMBER << "\tANY_NUMBER" << std::endl;
+	out << TokenId::ANY_IDENTIFIER << "\tANY_IDENTIFIER" << std::endl;
 
 	// Numbers
 	for (long double d = 1e-308L; d < 1; d *= 10)
-		std::cout << TokenizerBase::compress(static_cast<double>(d)) << '\t' << d << std::endl;
-	std::cout << TokenId::NUMBER_ZERO << "\t0" << std::endl;
+		out << TokenizerBase::compress(static_cast<double>(d)) << '\t' << d << std::endl;
+	out << TokenId::NUMBER_ZERO << "\t0" << std::endl;
 	for (long double d = 1; d < 1e309L; d *= 10)
-		std::cout << TokenizerBase::compress(static_cast<double>(d)) << '\t' << d << std::endl;
+		out << TokenizerBase::compress(static_cast<double>(d)) << '\t' << d << std::endl;
 
 	// RLE horizontal space
 	for (int i = 2; i <= TokenId::RLE_MAX; ++i)
-		std::cout << TokenId::RLE_SPACE + i << '\t' << "' ' * " << i << std::endl;
+		out << TokenId::RLE_SPACE + i << '\t' << "' ' * " << i << std::endl;
 	for (int i = 2; i <= TokenId::RLE_MAX; ++i)
-		std::cout << TokenId::RLE_TAB + i << '\t' << "'\\t' * " << i << std::endl;
+		out << TokenId::RLE_TAB + i << '\t' << "'\\t' * " << i << std::endl;
 
 	// Other token values
-	std::cout << TokenId::NUMBER_INFINITE << "\tINFINITE" << std::endl;
-	std::cout << TokenId::NUMBER_NAN << "\tNAN" << std::endl;
-	std::cout << TokenId::FIRST_IDENTIFIER << "\tFIRST_IDENTIFIER" << std::endl;
-	std::cout << TokenId::HASHED_CONTENT << "\tFIST_HASHED_CONTENT" << std::endl;
+	out << TokenId::NUMBER_INFINITE << "\tINFINITE" << std::endl;
+	out << TokenId::NUMBER_NAN << "\tNAN" << std::endl;
+	out << TokenId::FIRST_IDENTIFIER << "\tFIRST_IDENTIFIER" << std::endl;
+	out << TokenId::HASHED_CONTENT << "\tFIST_HASHED_CONTENT" << std::endl;
+}
+
+/*
+ * Open and process the specified file to the specified output and
+ * error streams.
+ * Return false if the file can't be opened.
+ */
+static bool
+tokenize_named_file(const std::string &filename, OutputSink &out,
+		std::ostream &err)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd == -1) {
+		err << "Unable to open " << filename <<
+			": " << strerror(errno) << std::endl;
+		return false;
+	}
+	// The binary output always contains file records
+	if (show_file_name && output_type != ot_binary)
+		out << "F" << filename << '\n';
+	CharSource cs(fd);
+	process_file(cs, filename, out, err);
+	close(fd);
+	return true;
 }
 
-// Open and process the specified file
+// Tokenize a file in a worker thread, keeping its output in memory
 static void
-process_named_file(std::string filename)
+tokenize_job(FileJob &job)
 {
-	std::ifstream in;
+	std::ostringstream err;
 
-	in.open(filename, std::ifstream::in);
-	if (!in.good()) {
-		std::cerr << "Unable to open " << filename <<
-			": " << strerror(errno) << std::endl;
-		exit(EXIT_FAILURE);
+	job.out.reset(new OutputSink());
+	job.ok = tokenize_named_file(job.filename, *job.out, err);
+	job.errors = err.str();
+}
+
+// Output the results of a job, in the order the files were specified
+static void
+complete_job(FileJob &job)
+{
+	std::cerr << job.errors;
+	OutputSink::standard_output() << job.out->str();
+	if (!job.ok) {
+		// Exit without waiting for the workers still running
+		OutputSink::standard_output().flush();
+		_exit(EXIT_FAILURE);
 	}
-	if (show_file_name)
-		std::cout << "F" << filename << std::endl;
-	process_file(in, filename);
-	in.close();
 }
 
-// Process the files listed in the specified input stream
+/*
+ * Output the n-grams counted by all threads, and discard the counts.
+ * Return false, after reporting the error to err, if they can't be merged.
+ */
+static bool
+output_ngrams(OutputSink &out, std::ostream &err)
+{
+	std::vector<NgramCounter *> counters;
+	bool ok;
+
+	for (auto &c : ngram_counters)
+		counters.push_back(c.second.get());
+	if (output_type == ot_binary) {
+		BinaryWriter writer(out, binary_encoding);
+		ok = NgramCounter::merge(counters,
+			[&writer](const token_type *key, uint64_t count) {
+				writer.ngram(key, ngram_length, count);
+			}, err);
+	} else {
+		char sep = separator ? separator : '\t';
+		ok = NgramCounter::merge(counters,
+			[&out, sep](const token_type *key, uint64_t count) {
+				for (unsigned i = 0; i < ngram_length; i++)
+					out << key[i] << sep;
+				out << count << '\n';
+			}, err);
+	}
+	ngram_counters.clear();
+	return ok;
+}
+
+// Output the clones found in all files
 static void
-process_files_from_stream(std::istream &in)
+output_clones(OutputSink &out)
+{
+	clones->detect([&out](const CloneDetector::Clone &c) {
+		for (int i = 0; i < 2; i++)
+			out << *c.file[i] << '\t' << c.begin[i] << '\t' <<
+				c.end[i] << '\t';
+		out << c.ntokens << '\n';
+	});
+}
+
+/*
+ * Open and process the specified file to the specified output and
+ * error streams, or pass it to the worker pool.
+ * Return false if the file can't be opened.
+ */
+static bool
+process_named_file(std::string filename, OutputSink &out, std::ostream &err)
+{
+	if (pool) {
+		pool->add(FileJob(filename));
+		return true;
+	}
+	return tokenize_named_file(filename, out, err);
+}
+
+// Process the files listed in the specified input stream
+static bool
+process_files_from_stream(std::istream &in, OutputSink &out,
+		std::ostream &err)
 {
 	std::string filename;
 
 	while (std::getline(in, filename))
-		process_named_file(filename);
+		if (!process_named_file(filename, out, err))
+			return false;
+	return true;
 }
 
-/* Read code and output its constituent tokens */
-int
-main(int argc, char * const argv[])
+// Set the command-line option values to their defaults
+static void
+reset_options()
+{
+	all_contents = false;
+	symbolic_output = false;
+	compress_ids = false;
+	show_file_name = false;
+	positions = false;
+	global_scope = false;
+	SymbolTable::enable_scoping();
+	output_type = ot_tokens;
+	binary_encoding = BinaryWriter::UINT32;
+	lang = "Java";
+	processing_opt.clear();
+	separator = 0;
+	jobs = 1;
+	cache_dir.reset();
+	cache_size = 1024;
+	files_list.reset();
+	ngram_length = 0;
+	ngram_memory = 1024;
+	clone_tokens = 0;
+	minhash_hashes = 0;
+	shingle_width = 4;
+	band_rows = 4;
+	index_output.reset();
+	index_query.reset();
+	server_socket.reset();
+	remote_socket.reset();
+}
+
+/*
+ * Set the option values from the specified command-line arguments,
+ * leaving optind at the first operand.
+ * Output requested information to out and error messages to err.
+ * Return -1 if processing should continue, or the exit status.
+ */
+static int
+parse_options(int argc, char * const argv[], std::ostream &out,
+		std::ostream &err)
 {
 	int opt;
-	std::optional<std::string> files_list(std::nullopt);
 
-	while ((opt = getopt(argc, argv, "aBbcfgi:Ll:o:st:V")) != -1)
+	// Restart the scanning of the arguments, which may be repeated
+#if defined(__GLIBC__)
+	optind = 0;
+#else
+	optreset = 1;
+	optind = 1;
+#endif
+	while ((opt = getopt(argc, argv, "aBbC:cd:e:fgi:j:k:LM:l:m:n:o:pq:R:r:S:st:Vw:x:")) != -1)
 		switch (opt) {
 		case 'a':
 			all_contents = true;
@@ -213,28 +567,123 @@ main(int argc, char * const argv[])
 		case 'b':
 			output_type = ot_break;
 			break;
+		case 'C':
+			cache_dir = optarg;
+			break;
 		case 'c':
 			compress_ids = true;
 			break;
+		case 'd':
+			clone_tokens = atoi(optarg);
+			if (clone_tokens < 1) {
+				err << "The clone size must be "
+					"a positive integer." << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'e':
+			output_type = ot_binary;
+			if (strcmp(optarg, "u32") == 0)
+				binary_encoding = BinaryWriter::UINT32;
+			else if (strcmp(optarg, "varint") == 0)
+				binary_encoding = BinaryWriter::VARINT;
+			else {
+				err << "Unknown binary encoding " <<
+					optarg << "; use u32 or varint." <<
+					std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
 		case 'f':
 			show_file_name = true;
 			break;
 		case 'g':
 			SymbolTable::disable_scoping();
+			global_scope = true;
 			break;
 		case 'i':
 			files_list = optarg;
 			break;
+		case 'j':
+			jobs = atoi(optarg);
+			if (jobs < 1) {
+				err << "The number of jobs must be "
+					"a positive integer." << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'k':
+			minhash_hashes = atoi(optarg);
+			if (minhash_hashes < 1 ||
+			    minhash_hashes > MinHash::MAX_HASHES) {
+				err << "The signature size must be between 1 and " <<
+					MinHash::MAX_HASHES << '.' << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
 		case 'L':
-			list_tokens();
-			exit(EXIT_SUCCESS);
+			list_tokens(out);
+			return EXIT_SUCCESS;
+		case 'M':
+			cache_size = strtoull(optarg, nullptr, 10);
+			if (cache_size < 1) {
+				err << "The cache size must be "
+					"a positive integer." << std::endl;
+				return EXIT_FAILURE;
+			}
 			break;
 		case 'l':
 			lang = optarg;
 			break;
+		case 'm':
+			ngram_memory = strtoull(optarg, nullptr, 10);
+			if (ngram_memory < 1) {
+				err << "The n-gram memory size must be "
+					"a positive integer." << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'n':
+			ngram_length = atoi(optarg);
+			if (ngram_length < 1 ||
+			    ngram_length > NgramCounter::MAX_N) {
+				err << "The n-gram length must be between 1 and " <<
+					NgramCounter::MAX_N << '.' << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
 		case 'o':
+			if (strcmp(optarg, "file") != 0 &&
+			    strcmp(optarg, "line") != 0 &&
+			    strcmp(optarg, "method") != 0 &&
+			    strcmp(optarg, "statement") != 0) {
+				err << "Unsupported processing option [" <<
+					optarg << "]" << std::endl;
+				err << "Valid options are one of file, line, method, statement" << std::endl;
+				return EXIT_FAILURE;
+			}
 			processing_opt.push_back(optarg);
 			break;
+		case 'p':
+			positions = true;
+			break;
+		case 'q':
+			index_query = optarg;
+			break;
+		case 'R':
+			remote_socket = optarg;
+			break;
+		case 'r':
+			band_rows = atoi(optarg);
+			if (band_rows < 1) {
+				err << "The number of band rows must be "
+					"a positive integer." << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'S':
+			server_socket = optarg;
+			break;
 		case 's':
 			symbolic_output = true;
 			break;
@@ -242,46 +691,324 @@ main(int argc, char * const argv[])
 			separator = *optarg;
 			break;
 		case 'V':
-			std::cout << "tokenizer " << version << std::endl;
-			exit(EXIT_SUCCESS);
+			out << "tokenizer " << version << std::endl;
+			return EXIT_SUCCESS;
+		case 'w':
+			shingle_width = atoi(optarg);
+			if (shingle_width < 1 ||
+			    shingle_width > MinHash::MAX_WIDTH) {
+				err << "The shingle width must be between 1 and " <<
+					MinHash::MAX_WIDTH << '.' << std::endl;
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'x':
+			index_output = optarg;
+			break;
 		default: /* ? */
-			std::cerr << "Usage: " << argv[0] <<
-				"  [-acgs | -B | -b] [-fV] [-i file] [-l lang] [-o opt] [-t sep] [file ...]" << std::endl;
-			exit(EXIT_FAILURE);
+			err << "Usage: " << argv[0] <<
+				"  [-acgs | -B | -b | -ac -e enc] [-fpV] [-C dir] [-d tokens] [-i file] [-j jobs] [-k hashes] [-l lang] [-M size] [-m size] [-n n] [-o opt] [-q index] [-R socket] [-r rows] [-t sep] [-w width] [-x index] [file ...]" << std::endl;
+			err << "       " << argv[0] << " -S socket" << std::endl;
+			return EXIT_FAILURE;
 		}
 
 	if (argv[optind] && files_list.has_value()) {
-		std::cerr << "Specify either an input file list or"
+		err << "Specify either an input file list or"
 			" command-line arguments; not both." << std::endl;
-		exit(EXIT_FAILURE);
+		return EXIT_FAILURE;
 	}
 
-	// Process tokens from standard input
-	if (!argv[optind] && !files_list.has_value()) {
-		process_file(std::cin, "-");
-		exit(EXIT_SUCCESS);
+	if (positions && (output_type == ot_tokens || compress_ids)) {
+		err << "Token positions can only be output with the"
+			" -B, -b, or -e options, and without -c." << std::endl;
+		return EXIT_FAILURE;
 	}
 
-	if (files_list.has_value()) {
+	if (ngram_length && (output_type == ot_break ||
+	    output_type == ot_type_break || symbolic_output || positions ||
+	    show_file_name || cache_dir.has_value())) {
+		err << "N-grams can only be counted with the numeric or the -e"
+			" output, and without -C, -f, -p, or -s." << std::endl;
+		return EXIT_FAILURE;
+	}
 
-		if (files_list.value() == "-") {
-			process_files_from_stream(std::cin);
+	if (clone_tokens && (output_type != ot_tokens || symbolic_output ||
+	    positions || show_file_name || cache_dir.has_value() ||
+	    ngram_length)) {
+		err << "Clones can only be detected without -B, -b, -C, -e,"
+			" -f, -n, -p, or -s." << std::endl;
+		return EXIT_FAILURE;
+	}
+	if ((minhash_hashes || index_query.has_value()) &&
+	    (output_type == ot_break || output_type == ot_type_break ||
+	    symbolic_output || positions || ngram_length || clone_tokens)) {
+		err << "Signatures can only be computed with the numeric or"
+			" the -e output, and without -d, -n, -p, or -s." <<
+			std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if ((index_output.has_value() || index_query.has_value()) &&
+	    (output_type == ot_binary || show_file_name ||
+	    cache_dir.has_value())) {
+		err << "Signature indexes can only be used without -C, -e,"
+			" or -f." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (index_output.has_value() && !minhash_hashes) {
+		err << "A signature index can only be written with -k." <<
+			std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (index_output.has_value() && band_rows > minhash_hashes) {
+		err << "The band rows must not exceed the signature size." <<
+			std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (index_query.has_value() && (minhash_hashes ||
+	    index_output.has_value())) {
+		err << "A signature index can only be queried without"
+			" -k or -x." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Lines are the default units of clones
+	if (clone_tokens && processing_opt.empty())
+		processing_opt.push_back("line");
+	return -1;
+}
+
+/*
+ * Tokenize the specified files, or the input specified through the
+ * options, according to the option values, to the specified output
+ * and error streams.
+ * Standard input is read from the specified input contents, or,
+ * if these are nullptr, from the process's standard input.
+ * Return the exit status.
+ */
+static int
+tokenize_input(char * const files[], const std::string *input,
+		OutputSink &out, std::ostream &err)
+{
+	// Report option errors before processing any input
+	CharSource empty(nullptr, 0);
+	if (!std::unique_ptr<TokenizerBase>(new_tokenizer(empty, "-"))) {
+		unknown_language(err);
+		return EXIT_FAILURE;
+	}
+
+	// Signatures are computed with the queried index's parameters
+	if (index_query.has_value()) {
+		index_queried = LshIndex::open(index_query.value());
+		if (!index_queried) {
+			err << "Unable to open signature index " <<
+				index_query.value() << ": " <<
+				strerror(errno) << std::endl;
+			return EXIT_FAILURE;
+		}
+		minhash_hashes = index_queried->get_nhashes();
+		shingle_width = index_queried->get_width();
+	}
+
+	if (clone_tokens)
+		clones.reset(new CloneDetector(clone_tokens));
+
+	if (index_output.has_value())
+		index_builder.reset(new LshIndex::Builder(minhash_hashes,
+			shingle_width, band_rows));
+
+	if (cache_dir.has_value()) {
+		cache = TokenCache::open(cache_dir.value(), cache_size << 20,
+			output_options());
+		if (!cache) {
+			err << "Unable to open cache directory " <<
+				cache_dir.value() << ": " << strerror(errno) <<
+				std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (output_type == ot_binary)
+		binary_header(out);
+
+	bool ok = true;
+	if (!files[0] && !files_list.has_value()) {
+		// Process tokens from standard input
+		if (input) {
+			CharSource cs(input->data(), input->size());
+			process_file(cs, "-", out, err);
 		} else {
+			CharSource cs(STDIN_FILENO);
+			process_file(cs, "-", out, err);
+		}
+	} else {
+		// Workers output directly to the standard output
+		if (jobs > 1 && !input)
+			pool.reset(new WorkerPool<FileJob>(jobs, tokenize_job,
+				complete_job));
+
+		if (files_list.value_or("") == "-") {
+			if (input) {
+				std::istringstream in(*input);
+				ok = process_files_from_stream(in, out, err);
+			} else
+				ok = process_files_from_stream(std::cin, out,
+					err);
+		} else if (files_list.has_value()) {
 			std::ifstream file_list_stream(files_list.value());
 			if (!file_list_stream) {
-				std::cerr << "Unable to open "
+				err << "Unable to open "
 					<< files_list.value() <<
 					": " << strerror(errno) << std::endl;
-				exit(EXIT_FAILURE);
-			}
-			process_files_from_stream(file_list_stream);
+				ok = false;
+			} else
+				ok = process_files_from_stream(file_list_stream,
+					out, err);
+		}
+
+		// Read from files specified as arguments
+		for (; ok && *files; files++)
+			ok = process_named_file(*files, out, err);
+
+		if (pool) {
+			pool->finish();
+			pool.reset();
+		}
+	}
+
+	if (ngram_length) {
+		if (ok)
+			ok = output_ngrams(out, err);
+		ngram_counters.clear();
+	}
+	if (clones) {
+		if (ok)
+			output_clones(out);
+		clones.reset();
+	}
+	if (index_builder) {
+		if (ok && !index_builder->write(index_output.value())) {
+			err << "Unable to create signature index " <<
+				index_output.value() << ": " <<
+				strerror(errno) << std::endl;
+			ok = false;
 		}
+		index_builder.reset();
+	}
+	index_queried.reset();
+
+	if (cache) {
+		cache->trim();
+		cache.reset();
+	}
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Run a request received by the server
+static int
+serve_request(const ServerRequest &r, OutputSink &out, std::ostream &err)
+{
+	std::vector<std::string> args(r.args);
+	std::vector<char *> argv;
+
+	argv.push_back(const_cast<char *>("tokenizer"));
+	for (auto &a : args)
+		argv.push_back(&a[0]);
+	argv.push_back(nullptr);
+
+	reset_options();
+	std::ostringstream info;
+	int status = parse_options(argv.size() - 1, argv.data(), info, err);
+	out << info.str();
+	if (status != -1)
+		return status;
+
+	if (chdir(r.directory.c_str()) == -1) {
+		err << "Unable to change directory to " << r.directory <<
+			": " << strerror(errno) << std::endl;
+		return EXIT_FAILURE;
+	}
+	// Requests are served one at a time, in a single thread
+	jobs = 1;
+	return tokenize_input(argv.data() + optind, &r.input, out, err);
+}
+
+// The server that signals stop
+static Server *running_server;
+
+static void
+stop_server(int)
+{
+	running_server->stop();
+}
+
+// Serve requests on the specified socket until terminated
+static int
+serve(const std::string &socket_path)
+{
+	Server server(socket_path);
+
+	if (!server.open(std::cerr))
+		return EXIT_FAILURE;
+	running_server = &server;
+	signal(SIGINT, stop_server);
+	signal(SIGTERM, stop_server);
+	signal(SIGHUP, stop_server);
+	server.run(serve_request);
+	return EXIT_SUCCESS;
+}
+
+/*
+ * Have the server listening on the specified socket run the tokenizer
+ * with the specified arguments in the current directory, passing it
+ * the standard input if it will be read.
+ * Return the run's exit status.
+ */
+static int
+remote_tokenize(const std::string &socket_path, int argc,
+		char * const argv[])
+{
+	ServerRequest r;
+
+	char *cwd = getcwd(nullptr, 0);
+	if (!cwd) {
+		std::cerr << "Unable to get the current directory: " <<
+			strerror(errno) << std::endl;
+		return EXIT_FAILURE;
+	}
+	r.directory = cwd;
+	free(cwd);
+
+	for (int i = 1; i < argc; i++)
+		r.args.push_back(argv[i]);
 
+	if ((!argv[optind] && !files_list.has_value()) ||
+	    files_list.value_or("") == "-") {
+		std::ostringstream in;
+		in << std::cin.rdbuf();
+		r.input = in.str();
 	}
 
-	// Read from files specified as arguments
-	for (; argv[optind]; optind++)
-		process_named_file(argv[optind]);
+	return Server::request(socket_path, r, OutputSink::standard_output(),
+		std::cerr);
+}
+
+/* Read code and output its constituent tokens */
+int
+main(int argc, char * const argv[])
+{
+	reset_options();
+	int status = parse_options(argc, argv, std::cout, std::cerr);
+	if (status != -1)
+		exit(status);
 
-	exit(EXIT_SUCCESS);
+	if (server_socket.has_value())
+		exit(serve(server_socket.value()));
+	if (remote_socket.has_value())
+		exit(remote_tokenize(remote_socket.value(), argc, argv));
+	exit(tokenize_input(argv + optind, nullptr,
+		OutputSink::standard_output(), std::cerr));
 }